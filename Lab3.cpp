@@ -1,6 +1,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sched.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 typedef struct Medicine {
     char name[100];
@@ -14,8 +28,47 @@ typedef struct Node {
     struct Node *left;
     struct Node *right;
     int height;
+    int size;
+    double valueSum;
 } Node;
 
+typedef struct MedicineRecord {
+    int medicineID;
+    Medicine data;
+} MedicineRecord;
+
+#ifndef TREE_STATS
+#define TREE_STATS 0
+#endif
+
+#define STATS_HISTORY 64
+
+typedef struct TreeStats {
+    long searches;
+    long searchComparisons;
+    long searchNodes;
+    long inserts;
+    long insertNodes;
+    long deletes;
+    long deleteNodes;
+    long rotations;
+    long allocations;
+    long frees;
+    long ticks;
+    int sampleEvery;
+    int dumpEvery;
+    int heightHistory[STATS_HISTORY];
+    int historyCount;
+} TreeStats;
+
+// Counters are per thread, so the parallel demos never race on them.
+#if TREE_STATS
+__thread TreeStats treeStats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 100, 0, {0}, 0};
+#define STAT_INC(field) (treeStats.field++)
+#else
+#define STAT_INC(field) ((void)0)
+#endif
+
 void clearInputBuffer() {
     int c;
     while ((c = getchar()) != '\n' && c != EOF);
@@ -43,6 +96,21 @@ void pressEnterToContinue() {
     getchar();
 }
 
+double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
 void printNode(Node* node) {
     if (node == NULL) return;
     printf("[ID: %-5d | Name: %-20s | Qty: %-5d | Price: $%.2f]\n",
@@ -59,13 +127,33 @@ int height(Node *n) {
     return n->height;
 }
 
+int nodeSize(Node *n) {
+    if (n == NULL)
+        return 0;
+    return n->size;
+}
+
+double nodeSum(Node *n) {
+    if (n == NULL)
+        return 0.0;
+    return n->valueSum;
+}
+
+double stockValue(Node *n) {
+    return (double)n->data.quantity * n->data.price;
+}
+
 void updateHeight(Node *n) {
-    if (n != NULL)
+    if (n != NULL) {
         n->height = 1 + max(height(n->left), height(n->right));
+        n->size = 1 + nodeSize(n->left) + nodeSize(n->right);
+        n->valueSum = stockValue(n) + nodeSum(n->left) + nodeSum(n->right);
+    }
 }
 
 Node* createNode(int id, Medicine data) {
     Node* newNode = (Node*)malloc(sizeof(Node));
+    STAT_INC(allocations);
     if (newNode == NULL) {
         printf("!! Fatal Error: Memory allocation failed.\n");
         exit(1);
@@ -75,6 +163,8 @@ Node* createNode(int id, Medicine data) {
     newNode->left = NULL;
     newNode->right = NULL;
     newNode->height = 1;
+    newNode->size = 1;
+    newNode->valueSum = stockValue(newNode);
     return newNode;
 }
 
@@ -83,6 +173,7 @@ void freeTree(Node* root) {
         freeTree(root->left);
         freeTree(root->right);
         free(root);
+        STAT_INC(frees);
     }
 }
 
@@ -93,6 +184,7 @@ Node *rightRotate(Node *y) {
     y->left = T2;
     updateHeight(y);
     updateHeight(x);
+    STAT_INC(rotations);
     return x;
 }
 
@@ -103,6 +195,7 @@ Node *leftRotate(Node *x) {
     x->right = T2;
     updateHeight(x);
     updateHeight(y);
+    STAT_INC(rotations);
     return y;
 }
 
@@ -112,13 +205,68 @@ int getBalance(Node *n) {
     return height(n->left) - height(n->right);
 }
 
+TreeStats treeStats_snapshot() {
+#if TREE_STATS
+    TreeStats snap = treeStats;
+#else
+    TreeStats snap;
+    memset(&snap, 0, sizeof(snap));
+#endif
+    return snap;
+}
+
+void treeStats_reset(int sampleEvery, int dumpEvery) {
+#if TREE_STATS
+    memset(&treeStats, 0, sizeof(treeStats));
+    treeStats.sampleEvery = sampleEvery > 0 ? sampleEvery : 1;
+    treeStats.dumpEvery = dumpEvery;
+#else
+    (void)sampleEvery;
+    (void)dumpEvery;
+#endif
+}
+
+double perOp(long total, long ops) {
+    return ops ? (double)total / ops : 0.0;
+}
+
+void treeStats_dump(FILE* out, const char* label) {
+    TreeStats s = treeStats_snapshot();
+    fprintf(out, "[stats %s] ops=%ld | search: %ld (%.2f cmp, %.2f nodes/op) | insert: %ld (%.2f nodes/op)"
+                 " | delete: %ld (%.2f nodes/op) | rotations=%ld | alloc=%ld free=%ld\n",
+            label, s.ticks, s.searches, perOp(s.searchComparisons, s.searches), perOp(s.searchNodes, s.searches),
+            s.inserts, perOp(s.insertNodes, s.inserts), s.deletes, perOp(s.deleteNodes, s.deletes),
+            s.rotations, s.allocations, s.frees);
+}
+
+#if TREE_STATS
+void treeStats_tick(Node* root) {
+    treeStats.ticks++;
+    if (treeStats.ticks % treeStats.sampleEvery == 0) {
+        int slot = treeStats.historyCount % STATS_HISTORY;
+        treeStats.heightHistory[slot] = height(root);
+        treeStats.historyCount++;
+    }
+    if (treeStats.dumpEvery > 0 && treeStats.ticks % treeStats.dumpEvery == 0)
+        treeStats_dump(stdout, "periodic");
+}
+#else
+inline void treeStats_tick(Node* root) {
+    (void)root;
+}
+#endif
+
 Node* bst_insert(Node* root, int id, Medicine data) {
-    if (root == NULL)
+    if (root == NULL) {
+        STAT_INC(inserts);
         return createNode(id, data);
+    }
+    STAT_INC(insertNodes);
     if (id < root->medicineID)
         root->left = bst_insert(root->left, id, data);
     else if (id > root->medicineID)
         root->right = bst_insert(root->right, id, data);
+    updateHeight(root);
     return root;
 }
 
@@ -132,6 +280,7 @@ Node* findMin(Node* root) {
 Node* bst_delete(Node* root, int id) {
     if (root == NULL)
         return root;
+    STAT_INC(deleteNodes);
     if (id < root->medicineID)
         root->left = bst_delete(root->left, id);
     else if (id > root->medicineID)
@@ -140,10 +289,14 @@ Node* bst_delete(Node* root, int id) {
         if (root->left == NULL) {
             Node *temp = root->right;
             free(root);
+            STAT_INC(frees);
+            STAT_INC(deletes);
             return temp;
         } else if (root->right == NULL) {
             Node *temp = root->left;
             free(root);
+            STAT_INC(frees);
+            STAT_INC(deletes);
             return temp;
         }
         Node* temp = findMin(root->right);
@@ -151,12 +304,16 @@ Node* bst_delete(Node* root, int id) {
         root->data = temp->data;
         root->right = bst_delete(root->right, temp->medicineID);
     }
+    updateHeight(root);
     return root;
 }
 
 Node* avl_insert(Node* root, int id, Medicine data) {
-    if (root == NULL)
+    if (root == NULL) {
+        STAT_INC(inserts);
         return createNode(id, data);
+    }
+    STAT_INC(insertNodes);
     if (id < root->medicineID)
         root->left = avl_insert(root->left, id, data);
     else if (id > root->medicineID)
@@ -187,6 +344,7 @@ Node* avl_insert(Node* root, int id, Medicine data) {
 Node* avl_delete(Node* root, int id) {
     if (root == NULL)
         return root;
+    STAT_INC(deleteNodes);
     if (id < root->medicineID)
         root->left = avl_delete(root->left, id);
     else if (id > root->medicineID)
@@ -200,6 +358,8 @@ Node* avl_delete(Node* root, int id) {
             } else 
                 *root = *temp; 
             free(temp);
+            STAT_INC(frees);
+            STAT_INC(deletes);
         } else {
             Node* temp = findMin(root->right);
             root->medicineID = temp->medicineID;
@@ -231,13 +391,127 @@ Node* avl_delete(Node* root, int id) {
     return root;
 }
 
+// Uncounted lookup for the existence checks done inside insert/delete paths
+Node* findNode(Node* root, int id) {
+    while (root != NULL && root->medicineID != id)
+        root = (id < root->medicineID) ? root->left : root->right;
+    return root;
+}
+
 Node* search(Node* root, int id) {
-    if (root == NULL || root->medicineID == id)
-        return root;
-    if (id < root->medicineID)
-        return search(root->left, id);
-    else
-        return search(root->right, id);
+    STAT_INC(searches);
+    while (root != NULL) {
+        STAT_INC(searchNodes);
+        STAT_INC(searchComparisons);
+        if (root->medicineID == id)
+            return root;
+        STAT_INC(searchComparisons);
+        root = (id < root->medicineID) ? root->left : root->right;
+    }
+    return NULL;
+}
+
+int rank(Node* root, int id) {
+    int count = 0;
+    while (root != NULL) {
+        if (id <= root->medicineID) {
+            root = root->left;
+        } else {
+            count += 1 + nodeSize(root->left);
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+Node* kthSmallest(Node* root, int k) {
+    while (root != NULL) {
+        int leftSize = nodeSize(root->left);
+        if (k <= leftSize) {
+            root = root->left;
+        } else if (k == leftSize + 1) {
+            return root;
+        } else {
+            k -= leftSize + 1;
+            root = root->right;
+        }
+    }
+    return NULL;
+}
+
+int countAtMost(Node* root, int id) {
+    int count = 0;
+    while (root != NULL) {
+        if (id < root->medicineID) {
+            root = root->left;
+        } else {
+            count += 1 + nodeSize(root->left);
+            root = root->right;
+        }
+    }
+    return count;
+}
+
+double sumBelow(Node* root, int id, int inclusive) {
+    double sum = 0.0;
+    while (root != NULL) {
+        if (id < root->medicineID || (!inclusive && id == root->medicineID)) {
+            root = root->left;
+        } else {
+            sum += stockValue(root) + nodeSum(root->left);
+            root = root->right;
+        }
+    }
+    return sum;
+}
+
+int rangeCount(Node* root, int a, int b) {
+    if (a > b)
+        return 0;
+    return countAtMost(root, b) - rank(root, a);
+}
+
+double rangeSum(Node* root, int a, int b) {
+    if (a > b)
+        return 0.0;
+    return sumBelow(root, b, 1) - sumBelow(root, a, 0);
+}
+
+#define BATCH_GROUP 16
+
+void searchBatch(Node* root, const int* ids, int n, Node** out) {
+    Node* cursor[BATCH_GROUP];
+    int query[BATCH_GROUP];
+    int active = 0, next = 0;
+
+    while (active < BATCH_GROUP && next < n) {
+        cursor[active] = root;
+        query[active] = next++;
+        active++;
+    }
+
+    while (active > 0) {
+        for (int s = 0; s < active; s++) {
+            Node* node = cursor[s];
+            int id = ids[query[s]];
+            if (node == NULL || node->medicineID == id) {
+                out[query[s]] = node;
+                if (next < n) {
+                    cursor[s] = root;
+                    query[s] = next++;
+                } else {
+                    active--;
+                    cursor[s] = cursor[active];
+                    query[s] = query[active];
+                    s--;
+                }
+                continue;
+            }
+            node = (id < node->medicineID) ? node->left : node->right;
+            __builtin_prefetch(node);
+            cursor[s] = node;
+        }
+    }
 }
 
 void morrisInorder(Node* root) {
@@ -357,164 +631,2737 @@ void morrisPostorder(Node* root) {
 }
 
 
-void displayMenu(Node* root) {
-    int choice;
-    while(1) {
-        printf("\n  -- Display Menu (Morris Traversal) --\n");
-        printf("  1. Inorder (Sorted by ID)\n");
-        printf("  2. Preorder\n");
-        printf("  3. Postorder\n");
-        printf("  4. Back\n");
-        choice = getInt();
-        
-        switch(choice) {
-            case 1:
-                printf("\n--- Morris Inorder Traversal ---\n");
-                morrisInorder(root);
-                break;
-            case 2:
-                printf("\n--- Morris Preorder Traversal ---\n");
-                morrisPreorder(root);
-                break;
-            case 3:
-                printf("\n--- Morris Postorder Traversal ---\n");
-                morrisPostorder(root);
-                break;
-            case 4:
-                return;
-            default:
-                printf("!! Invalid choice.\n");
+int flattenInorder(Node* root, Node** out) {
+    Node *current = root, *pre;
+    int count = 0;
+    while (current != NULL) {
+        if (current->left == NULL) {
+            out[count++] = current;
+            current = current->right;
+        } else {
+            pre = current->left;
+            while (pre->right != NULL && pre->right != current)
+                pre = pre->right;
+
+            if (pre->right == NULL) {
+                pre->right = current;
+                current = current->left;
+            } else {
+                pre->right = NULL;
+                out[count++] = current;
+                current = current->right;
+            }
         }
     }
+    return count;
 }
 
-Node* runGuidedDemo(Node* root, int isAVL) {
-    printf("\n--- [Running Guided Demo] ---\n");
-    printf("Action: Clearing any existing data...\n");
-    freeTree(root);
-    root = NULL;
-    pressEnterToContinue();
-
-    printf("[SCENARIO 1: Initial Stocking]\n");
-    printf("Action: Inserting 5 medicines: (50, Paracetamol), (25, Ibuprofen), (75, Aspirin), (15, Amoxicillin), (30, Metformin)\n");
-    Medicine m1 = {"Paracetamol", 100, 5.50};
-    Medicine m2 = {"Ibuprofen", 50, 8.00};
-    Medicine m3 = {"Aspirin", 75, 3.25};
-    Medicine m4 = {"Amoxicillin", 120, 15.00};
-    Medicine m5 = {"Metformin", 60, 12.75};
+Node* linkBalanced(Node** nodes, int lo, int hi) {
+    if (lo > hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    Node* root = nodes[mid];
+    root->left = linkBalanced(nodes, lo, mid - 1);
+    root->right = linkBalanced(nodes, mid + 1, hi);
+    updateHeight(root);
+    return root;
+}
 
-    if(isAVL) {
-        root = avl_insert(root, 50, m1);
-        root = avl_insert(root, 25, m2);
-        root = avl_insert(root, 75, m3);
-        root = avl_insert(root, 15, m4);
-        root = avl_insert(root, 30, m5); 
-    } else {
-        root = bst_insert(root, 50, m1);
-        root = bst_insert(root, 25, m2);
-        root = bst_insert(root, 75, m3);
-        root = bst_insert(root, 15, m4);
-        root = bst_insert(root, 30, m5);
+void sortRecords(MedicineRecord* items, int n) {
+    MedicineRecord* buffer = (MedicineRecord*)malloc(n * sizeof(MedicineRecord));
+    if (buffer == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
     }
-    printf("Current Inventory (Inorder):\n");
-    morrisInorder(root);
-    pressEnterToContinue();
-
-    printf("[SCENARIO 2: Searching Inventory]\n");
-    printf("Action: Searching for Medicine ID 30 (Metformin)...\n");
-    Node* found = search(root, 30);
-    if(found) { printf("Result: Found! "); printNode(found); }
-    else { printf("Result: Not Found.\n"); }
-
-    printf("\nAction: Searching for Medicine ID 99 (Non-existent)...\n");
-    found = search(root, 99);
-    if(found) { printf("Result: Found! "); printNode(found); }
-    else { printf("Result: Not Found.\n"); }
-    pressEnterToContinue();
+    MedicineRecord* from = items;
+    MedicineRecord* to = buffer;
+    for (int width = 1; width < n; width *= 2) {
+        for (int lo = 0; lo < n; lo += 2 * width) {
+            int mid = lo + width < n ? lo + width : n;
+            int hi = lo + 2 * width < n ? lo + 2 * width : n;
+            int i = lo, j = mid, k = lo;
+            while (i < mid && j < hi)
+                to[k++] = from[j].medicineID < from[i].medicineID ? from[j++] : from[i++];
+            while (i < mid)
+                to[k++] = from[i++];
+            while (j < hi)
+                to[k++] = from[j++];
+        }
+        MedicineRecord* t = from;
+        from = to;
+        to = t;
+    }
+    if (from != items)
+        memcpy(items, from, n * sizeof(MedicineRecord));
+    free(buffer);
+}
 
-    printf("[SCENARIO 3: Deleting Items]\n");
-    printf("Action: Deleting Medicine ID 15 (Amoxicillin) - a leaf node.\n");
-    if(isAVL) { root = avl_delete(root, 15); }
-    else { root = bst_delete(root, 15); }
-    printf("Current Inventory (Inorder):\n");
-    morrisInorder(root);
-    pressEnterToContinue();
+// Returns the records in strictly ascending ID order without touching the caller's
+// array. Input that is already strictly ascending is returned as-is; otherwise a
+// stably sorted copy is made (*copy, freed by the caller) and for a repeated ID the
+// last record in input order wins, the same rule avl_bulkMerge applies to the tree.
+const MedicineRecord* prepareRecords(const MedicineRecord* items, int* n, MedicineRecord** copy) {
+    *copy = NULL;
+    int sorted = 1;
+    for (int i = 1; i < *n && sorted; i++)
+        if (items[i - 1].medicineID >= items[i].medicineID)
+            sorted = 0;
+    if (sorted)
+        return items;
 
-    printf("Action: Deleting Medicine ID 75 (Aspirin) - a leaf node.\n");
-    if(isAVL) { root = avl_delete(root, 75); }
-    else { root = bst_delete(root, 75); }
-    printf("Current Inventory (Inorder):\n");
-    morrisInorder(root);
-    pressEnterToContinue();
+    MedicineRecord* out = (MedicineRecord*)malloc(*n * sizeof(MedicineRecord));
+    if (out == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(out, items, *n * sizeof(MedicineRecord));
+    sortRecords(out, *n);
+    int unique = 0;
+    for (int i = 0; i < *n; i++) {
+        if (unique > 0 && out[unique - 1].medicineID == out[i].medicineID)
+            out[unique - 1] = out[i];
+        else
+            out[unique++] = out[i];
+    }
+    *n = unique;
+    *copy = out;
+    return out;
+}
 
-    printf("Action: Deleting Medicine ID 50 (Paracetamol) - the root node with two children.\n");
-    if(isAVL) { root = avl_delete(root, 50); } 
-    else { root = bst_delete(root, 50); }
-    printf("Current Inventory (Inorder):\n");
-    morrisInorder(root);
-    
-    printf("\n--- [Demo Complete] ---\n");
+Node* avl_bulkLoad(const MedicineRecord* input, int n) {
+    if (n <= 0)
+        return NULL;
+    MedicineRecord* copy;
+    const MedicineRecord* items = prepareRecords(input, &n, &copy);
+    Node** nodes = (Node**)malloc(n * sizeof(Node*));
+    if (nodes == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++)
+        nodes[i] = createNode(items[i].medicineID, items[i].data);
+    Node* root = linkBalanced(nodes, 0, n - 1);
+    free(nodes);
+    free(copy);
     return root;
 }
 
-Node* loadSkewedData(Node* root, int isAVL) {
-    printf("\n--- [Loading Skewed Data Demo] ---\n");
-    printf("Action: Clearing any existing data...\n");
-    freeTree(root);
-    root = NULL;
+// Folds a batch into the tree; a batch record whose ID is already present
+// replaces that medicine's data (last one wins), matching prepareRecords.
+Node* avl_bulkMerge(Node* root, const MedicineRecord* input, int n) {
+    if (n <= 0)
+        return root;
+    MedicineRecord* copy;
+    const MedicineRecord* items = prepareRecords(input, &n, &copy);
+    int existing = nodeSize(root);
+    Node** oldNodes = (Node**)malloc((existing + 1) * sizeof(Node*));
+    Node** nodes = (Node**)malloc((existing + n) * sizeof(Node*));
+    if (oldNodes == NULL || nodes == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    existing = flattenInorder(root, oldNodes);
 
-    printf("Action: Inserting IDs 10, 20, 30, 40, 50 in ascending order.\n");
-    int ids[] = {10, 20, 30, 40, 50};
-    char names[][100] = {"Med-A", "Med-B", "Med-C", "Med-D", "Med-E"};
-    
-    for(int i=0; i<5; i++) {
-        Medicine m = {"", 0, 0.0};
-        strcpy(m.name, names[i]);
-        m.quantity = 10 * (i+1);
-        m.price = 5.0 * (i+1);
-        
-        if(isAVL) {
-            root = avl_insert(root, ids[i], m);
+    int i = 0, j = 0, count = 0;
+    while (i < existing || j < n) {
+        if (j >= n || (i < existing && oldNodes[i]->medicineID < items[j].medicineID)) {
+            nodes[count++] = oldNodes[i++];
+        } else if (i >= existing || items[j].medicineID < oldNodes[i]->medicineID) {
+            nodes[count++] = createNode(items[j].medicineID, items[j].data);
+            j++;
         } else {
-            root = bst_insert(root, ids[i], m);
+            oldNodes[i]->data = items[j].data;
+            nodes[count++] = oldNodes[i++];
+            j++;
         }
     }
-    
-    printf("-> Skewed data loaded.\n");
-    if(isAVL) {
-        printf("Notice: The AVL tree rebalanced itself during insertions.\n");
-    } else {
-        printf("Notice: The BST is now a degenerate tree (a linked list).\n");
-    }
-    printf("Use 'Display Inventory' (Preorder) to see the resulting structure.\n");
+
+    root = linkBalanced(nodes, 0, count - 1);
+    free(oldNodes);
+    free(nodes);
+    free(copy);
     return root;
 }
 
-void handleTree(Node** root, int isAVL) {
-    int choice, id;
-    Node* found;
-    Medicine data;
-    char treeType[4];
-    strcpy(treeType, isAVL ? "AVL" : "BST");
+#define MAX_READERS 64
 
-    while (1) {
-        printf("\n--- Pharmacy Management (%s Tree) ---\n", treeType);
-        printf("1. Insert Medicine\n");
-        printf("2. Delete Medicine\n");
-        printf("3. Search Medicine\n");
-        printf("4. Display Inventory\n");
-        printf("5. Run Guided Demo\n");
-        printf("6. Load Skewed Data (for Demo)\n");
-        printf("7. Back to Main Menu\n");
+typedef struct RetireList {
+    void** items;
+    int count;
+    int capacity;
+} RetireList;
 
-        choice = getInt();
+// One cache line per slot, so readers announcing epochs do not false-share
+typedef struct __attribute__((aligned(64))) ReaderSlot {
+    long announced;
+    int inUse;
+} ReaderSlot;
 
-        switch (choice) {
-            case 1:
-                printf("  Enter Medicine ID (Key): ");
-                id = getInt();
-                found = search(*root, id);
-                if (found != NULL) {
+typedef struct PublishedVersion {
+    Node* root;
+    long version;
+} PublishedVersion;
+
+typedef struct PersistentInventory {
+    PublishedVersion* current;
+    long epoch;
+    ReaderSlot readers[MAX_READERS];
+    RetireList limbo[3];
+    RetireList pending;
+    long reclaimed;
+    pthread_mutex_t writeLock;
+} PersistentInventory;
+
+typedef struct Snapshot {
+    Node* root;
+    long version;
+} Snapshot;
+
+void retire(RetireList* list, void* p) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->items = (void**)realloc(list->items, list->capacity * sizeof(void*));
+        if (list->items == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    list->items[list->count++] = p;
+}
+
+Node* copyNode(Node* n, RetireList* retired) {
+    Node* copy = (Node*)malloc(sizeof(Node));
+    STAT_INC(allocations);
+    if (copy == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    *copy = *n;
+    retire(retired, n);
+    return copy;
+}
+
+// root is already a private copy; pathSide says which child the update came
+// through (-1 left, 1 right). After an insert the heavy side is that path, so
+// the nodes a rotation touches are fresh copies too. After a delete the heavy
+// side is the other one and still shared with the published version, so only
+// those nodes are copied before rotating.
+Node* pavl_rebalance(Node* root, int pathSide, RetireList* retired) {
+    updateHeight(root);
+    int balance = getBalance(root);
+
+    if (balance > 1) {
+        if (pathSide > 0)
+            root->left = copyNode(root->left, retired);
+        if (getBalance(root->left) < 0) {
+            if (pathSide > 0)
+                root->left->right = copyNode(root->left->right, retired);
+            root->left = leftRotate(root->left);
+        }
+        return rightRotate(root);
+    }
+    if (balance < -1) {
+        if (pathSide < 0)
+            root->right = copyNode(root->right, retired);
+        if (getBalance(root->right) > 0) {
+            if (pathSide < 0)
+                root->right->left = copyNode(root->right->left, retired);
+            root->right = rightRotate(root->right);
+        }
+        return leftRotate(root);
+    }
+    return root;
+}
+
+Node* pavl_insert(Node* root, int id, Medicine data, RetireList* retired) {
+    if (root == NULL)
+        return createNode(id, data);
+    root = copyNode(root, retired);
+    if (id < root->medicineID) {
+        root->left = pavl_insert(root->left, id, data, retired);
+        return pavl_rebalance(root, -1, retired);
+    }
+    root->right = pavl_insert(root->right, id, data, retired);
+    return pavl_rebalance(root, 1, retired);
+}
+
+Node* pavl_delete(Node* root, int id, RetireList* retired) {
+    if (root == NULL)
+        return NULL;
+    if (id == root->medicineID && (root->left == NULL || root->right == NULL)) {
+        retire(retired, root);
+        return root->left ? root->left : root->right;
+    }
+    root = copyNode(root, retired);
+    if (id < root->medicineID) {
+        root->left = pavl_delete(root->left, id, retired);
+        return pavl_rebalance(root, -1, retired);
+    }
+    if (id > root->medicineID) {
+        root->right = pavl_delete(root->right, id, retired);
+    } else {
+        Node* successor = findMin(root->right);
+        root->medicineID = successor->medicineID;
+        root->data = successor->data;
+        root->right = pavl_delete(root->right, successor->medicineID, retired);
+    }
+    return pavl_rebalance(root, 1, retired);
+}
+
+PublishedVersion* newVersion(Node* root, long version) {
+    PublishedVersion* v = (PublishedVersion*)malloc(sizeof(PublishedVersion));
+    STAT_INC(allocations);
+    if (v == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    v->root = root;
+    v->version = version;
+    return v;
+}
+
+void pavl_init(PersistentInventory* inv) {
+    memset(inv, 0, sizeof(PersistentInventory));
+    inv->current = newVersion(NULL, 0);
+    pthread_mutex_init(&inv->writeLock, NULL);
+}
+
+int pavl_registerReader(PersistentInventory* inv) {
+    for (int slot = 0; slot < MAX_READERS; slot++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&inv->readers[slot].inUse, &expected, 1, 0,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            return slot;
+    }
+    return -1;
+}
+
+void pavl_unregisterReader(PersistentInventory* inv, int slot) {
+    __atomic_store_n(&inv->readers[slot].announced, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&inv->readers[slot].inUse, 0, __ATOMIC_RELEASE);
+}
+
+Snapshot pavl_readBegin(PersistentInventory* inv, int slot) {
+    long e = __atomic_load_n(&inv->epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&inv->readers[slot].announced, (e << 1) | 1, __ATOMIC_SEQ_CST);
+    PublishedVersion* current = __atomic_load_n(&inv->current, __ATOMIC_SEQ_CST);
+    Snapshot snap;
+    snap.root = current->root;
+    snap.version = current->version;
+    return snap;
+}
+
+void pavl_readEnd(PersistentInventory* inv, int slot) {
+    __atomic_store_n(&inv->readers[slot].announced, 0, __ATOMIC_RELEASE);
+}
+
+void freeRetired(RetireList* list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->items[i]);
+        STAT_INC(frees);
+    }
+    list->count = 0;
+}
+
+void pavl_tryAdvanceEpoch(PersistentInventory* inv) {
+    long e = __atomic_load_n(&inv->epoch, __ATOMIC_SEQ_CST);
+    for (int i = 0; i < MAX_READERS; i++) {
+        long a = __atomic_load_n(&inv->readers[i].announced, __ATOMIC_SEQ_CST);
+        if ((a & 1) && (a >> 1) != e)
+            return;
+    }
+    __atomic_store_n(&inv->epoch, e + 1, __ATOMIC_SEQ_CST);
+    RetireList* expired = &inv->limbo[(e + 2) % 3];
+    inv->reclaimed += expired->count;
+    freeRetired(expired);
+}
+
+void pavl_publish(PersistentInventory* inv, Node* newRoot) {
+    PublishedVersion* old = inv->current;
+    __atomic_store_n(&inv->current, newVersion(newRoot, old->version + 1), __ATOMIC_SEQ_CST);
+
+    long e = __atomic_load_n(&inv->epoch, __ATOMIC_SEQ_CST);
+    RetireList* bucket = &inv->limbo[e % 3];
+    retire(bucket, old);
+    for (int i = 0; i < inv->pending.count; i++)
+        retire(bucket, inv->pending.items[i]);
+    inv->pending.count = 0;
+    pavl_tryAdvanceEpoch(inv);
+}
+
+int pavl_update(PersistentInventory* inv, int id, Medicine* data, int isInsert) {
+    int changed = 0;
+    pthread_mutex_lock(&inv->writeLock);
+    Node* root = inv->current->root;
+    Node* found = search(root, id);
+    if (isInsert && found == NULL) {
+        pavl_publish(inv, pavl_insert(root, id, *data, &inv->pending));
+        changed = 1;
+    } else if (!isInsert && found != NULL) {
+        pavl_publish(inv, pavl_delete(root, id, &inv->pending));
+        changed = 1;
+    }
+    pthread_mutex_unlock(&inv->writeLock);
+    return changed;
+}
+
+int pavl_insertMedicine(PersistentInventory* inv, int id, Medicine data) {
+    return pavl_update(inv, id, &data, 1);
+}
+
+int pavl_deleteMedicine(PersistentInventory* inv, int id) {
+    return pavl_update(inv, id, NULL, 0);
+}
+
+void pavl_destroy(PersistentInventory* inv) {
+    freeTree(inv->current->root);
+    free(inv->current);
+    for (int i = 0; i < 3; i++) {
+        freeRetired(&inv->limbo[i]);
+        free(inv->limbo[i].items);
+    }
+    free(inv->pending.items);
+    pthread_mutex_destroy(&inv->writeLock);
+    inv->current = NULL;
+}
+
+int snapshotWalk(Node* root, double* valueOut) {
+    Node* stack[64];
+    int top = 0, count = 0;
+    double value = 0.0;
+    Node* current = root;
+    while (current != NULL || top > 0) {
+        while (current != NULL) {
+            stack[top++] = current;
+            current = current->left;
+        }
+        current = stack[--top];
+        count++;
+        value += stockValue(current);
+        current = current->right;
+    }
+    *valueOut = value;
+    return count;
+}
+
+typedef struct EytzingerIndex {
+    int* keys;
+    Medicine* payload;
+    int n;
+} EytzingerIndex;
+
+void eytzFill(Node** sorted, int* next, EytzingerIndex* index, int k) {
+    if (k > index->n)
+        return;
+    eytzFill(sorted, next, index, 2 * k);
+    index->keys[k] = sorted[*next]->medicineID;
+    index->payload[k] = sorted[*next]->data;
+    (*next)++;
+    eytzFill(sorted, next, index, 2 * k + 1);
+}
+
+EytzingerIndex* eytz_build(Node* root) {
+    int n = nodeSize(root);
+    size_t keyBytes = ((size_t)(n + 1) * sizeof(int) + 63) / 64 * 64;
+    EytzingerIndex* index = (EytzingerIndex*)malloc(sizeof(EytzingerIndex));
+    Node** sorted = (Node**)malloc((n + 1) * sizeof(Node*));
+    int* keys = (int*)aligned_alloc(64, keyBytes);
+    Medicine* payload = (Medicine*)malloc((n + 1) * sizeof(Medicine));
+    if (index == NULL || sorted == NULL || keys == NULL || payload == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    index->keys = keys;
+    index->payload = payload;
+    index->n = flattenInorder(root, sorted);
+    index->keys[0] = 0;
+    int next = 0;
+    eytzFill(sorted, &next, index, 1);
+    free(sorted);
+    return index;
+}
+
+int eytz_search(const EytzingerIndex* index, int id) {
+    const int* keys = index->keys;
+    int n = index->n;
+    int k = 1;
+    while (k <= n) {
+        __builtin_prefetch(keys + 16 * k);
+        k = 2 * k + (keys[k] < id);
+    }
+    k >>= __builtin_ffs(~k);
+    return (k != 0 && keys[k] == id) ? k : 0;
+}
+
+void eytz_free(EytzingerIndex* index) {
+    if (index == NULL)
+        return;
+    free(index->keys);
+    free(index->payload);
+    free(index);
+}
+
+typedef struct NameEntry {
+    int medicineID;
+    struct NameEntry* next;
+} NameEntry;
+
+typedef struct TSTNode {
+    char splitChar;
+    int lo, eq, hi;
+    NameEntry* ids;
+} TSTNode;
+
+typedef struct NameIndex {
+    TSTNode* nodes;
+    int count;
+    int capacity;
+    int root;
+    int freeList;
+} NameIndex;
+
+void nameIndex_init(NameIndex* index) {
+    index->capacity = 64;
+    index->nodes = (TSTNode*)malloc(index->capacity * sizeof(TSTNode));
+    if (index->nodes == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    index->count = 1;
+    index->root = 0;
+    index->freeList = 0;
+}
+
+int newTSTNode(NameIndex* index, char c) {
+    if (index->freeList != 0) {
+        int reused = index->freeList;
+        TSTNode* node = &index->nodes[reused];
+        index->freeList = node->lo;
+        node->splitChar = c;
+        node->lo = node->eq = node->hi = 0;
+        node->ids = NULL;
+        return reused;
+    }
+    if (index->count == index->capacity) {
+        index->capacity *= 2;
+        index->nodes = (TSTNode*)realloc(index->nodes, index->capacity * sizeof(TSTNode));
+        if (index->nodes == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    TSTNode* node = &index->nodes[index->count];
+    node->splitChar = c;
+    node->lo = node->eq = node->hi = 0;
+    node->ids = NULL;
+    return index->count++;
+}
+
+void nameIndex_add(NameIndex* index, const char* name, int id) {
+    if (name[0] == '\0')
+        return;
+    int cur = index->root, parent = 0, dir = 0;
+    const char* p = name;
+    while (1) {
+        char c = (char)tolower((unsigned char)*p);
+        if (cur == 0) {
+            cur = newTSTNode(index, c);
+            if (parent == 0)
+                index->root = cur;
+            else if (dir < 0)
+                index->nodes[parent].lo = cur;
+            else if (dir > 0)
+                index->nodes[parent].hi = cur;
+            else
+                index->nodes[parent].eq = cur;
+        }
+        TSTNode* node = &index->nodes[cur];
+        parent = cur;
+        if (c < node->splitChar) {
+            dir = -1;
+            cur = node->lo;
+        } else if (c > node->splitChar) {
+            dir = 1;
+            cur = node->hi;
+        } else if (p[1] == '\0') {
+            NameEntry* entry = (NameEntry*)malloc(sizeof(NameEntry));
+            if (entry == NULL) {
+                printf("!! Fatal Error: Memory allocation failed.\n");
+                exit(1);
+            }
+            entry->medicineID = id;
+            entry->next = node->ids;
+            node->ids = entry;
+            return;
+        } else {
+            dir = 0;
+            cur = node->eq;
+            p++;
+        }
+    }
+}
+
+int nameIndex_find(NameIndex* index, const char* key) {
+    if (key[0] == '\0')
+        return 0;
+    int cur = index->root;
+    const char* p = key;
+    while (cur != 0) {
+        char c = (char)tolower((unsigned char)*p);
+        TSTNode* node = &index->nodes[cur];
+        if (c < node->splitChar)
+            cur = node->lo;
+        else if (c > node->splitChar)
+            cur = node->hi;
+        else if (p[1] == '\0')
+            return cur;
+        else {
+            cur = node->eq;
+            p++;
+        }
+    }
+    return 0;
+}
+
+// Removes id under name and returns the new subtree root. A node left with no
+// IDs and no eq child ends no name, so it is unlinked (its lo and hi subtrees
+// are spliced together) and its slot goes on the free list for reuse.
+int tstRemove(NameIndex* index, int cur, const char* p, int id) {
+    if (cur == 0)
+        return 0;
+    TSTNode* node = &index->nodes[cur];
+    char c = (char)tolower((unsigned char)*p);
+    if (c < node->splitChar) {
+        node->lo = tstRemove(index, node->lo, p, id);
+    } else if (c > node->splitChar) {
+        node->hi = tstRemove(index, node->hi, p, id);
+    } else if (p[1] != '\0') {
+        node->eq = tstRemove(index, node->eq, p + 1, id);
+    } else {
+        NameEntry** link = &node->ids;
+        while (*link != NULL && (*link)->medicineID != id)
+            link = &(*link)->next;
+        if (*link != NULL) {
+            NameEntry* dead = *link;
+            *link = dead->next;
+            free(dead);
+        }
+    }
+    if (node->ids != NULL || node->eq != 0)
+        return cur;
+
+    int rest = node->lo ? node->lo : node->hi;
+    if (node->lo != 0 && node->hi != 0) {
+        int last = node->lo;
+        while (index->nodes[last].hi != 0)
+            last = index->nodes[last].hi;
+        index->nodes[last].hi = node->hi;
+    }
+    node->lo = index->freeList;
+    index->freeList = cur;
+    return rest;
+}
+
+void nameIndex_remove(NameIndex* index, const char* name, int id) {
+    if (name[0] == '\0')
+        return;
+    index->root = tstRemove(index, index->root, name, id);
+}
+
+NameEntry* nameIndex_exact(NameIndex* index, const char* name) {
+    int cur = nameIndex_find(index, name);
+    return cur ? index->nodes[cur].ids : NULL;
+}
+
+int collectNames(NameIndex* index, int cur, int* out, int limit, int count) {
+    if (cur == 0 || count >= limit)
+        return count;
+    TSTNode* node = &index->nodes[cur];
+    count = collectNames(index, node->lo, out, limit, count);
+    for (NameEntry* e = node->ids; e != NULL && count < limit; e = e->next)
+        out[count++] = e->medicineID;
+    count = collectNames(index, node->eq, out, limit, count);
+    return collectNames(index, node->hi, out, limit, count);
+}
+
+int nameIndex_prefix(NameIndex* index, const char* prefix, int* out, int limit) {
+    int cur = nameIndex_find(index, prefix);
+    if (cur == 0)
+        return 0;
+    int count = 0;
+    for (NameEntry* e = index->nodes[cur].ids; e != NULL && count < limit; e = e->next)
+        out[count++] = e->medicineID;
+    return collectNames(index, index->nodes[cur].eq, out, limit, count);
+}
+
+void nameIndex_clear(NameIndex* index) {
+    for (int i = 1; i < index->count; i++) {
+        NameEntry* e = index->nodes[i].ids;
+        while (e != NULL) {
+            NameEntry* next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    index->count = 1;
+    index->root = 0;
+    index->freeList = 0;
+}
+
+void nameIndex_free(NameIndex* index) {
+    nameIndex_clear(index);
+    free(index->nodes);
+    index->nodes = NULL;
+}
+
+void nameIndex_rebuild(NameIndex* index, Node* root) {
+    nameIndex_clear(index);
+    int n = nodeSize(root);
+    if (n == 0)
+        return;
+    Node** sorted = (Node**)malloc(n * sizeof(Node*));
+    if (sorted == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    n = flattenInorder(root, sorted);
+    for (int i = 0; i < n; i++)
+        nameIndex_add(index, sorted[i]->data.name, sorted[i]->medicineID);
+    free(sorted);
+}
+
+Node* inventoryInsert(Node* root, NameIndex* names, int id, Medicine data, int isAVL) {
+    if (findNode(root, id) == NULL) {
+        nameIndex_add(names, data.name, id);
+        root = isAVL ? avl_insert(root, id, data) : bst_insert(root, id, data);
+    }
+    treeStats_tick(root);
+    return root;
+}
+
+Node* inventoryDelete(Node* root, NameIndex* names, int id, int isAVL) {
+    Node* found = findNode(root, id);
+    if (found != NULL) {
+        nameIndex_remove(names, found->data.name, id);
+        root = isAVL ? avl_delete(root, id) : bst_delete(root, id);
+    }
+    treeStats_tick(root);
+    return root;
+}
+
+#define ART_NODE4 0
+#define ART_NODE16 1
+#define ART_NODE48 2
+#define ART_NODE256 3
+#define ART_IS_LEAF(p) (((uintptr_t)(p)) & 1)
+#define ART_LEAF(p) ((ArtLeaf*)(((uintptr_t)(p)) & ~(uintptr_t)1))
+#define ART_TAG_LEAF(l) ((void*)(((uintptr_t)(l)) | 1))
+
+typedef struct ArtLeaf {
+    unsigned int key;
+    int medicineID;
+    Medicine data;
+} ArtLeaf;
+
+typedef struct ArtNode {
+    unsigned char type;
+    unsigned char prefixLen;
+    unsigned short numChildren;
+    unsigned char prefix[4];
+} ArtNode;
+
+typedef struct ArtNode4 {
+    ArtNode n;
+    unsigned char keys[4];
+    void* children[4];
+} ArtNode4;
+
+typedef struct ArtNode16 {
+    ArtNode n;
+    unsigned char keys[16];
+    void* children[16];
+} ArtNode16;
+
+typedef struct ArtNode48 {
+    ArtNode n;
+    unsigned char childIndex[256];
+    void* children[48];
+} ArtNode48;
+
+typedef struct ArtNode256 {
+    ArtNode n;
+    void* children[256];
+} ArtNode256;
+
+typedef struct ArtTree {
+    void* root;
+    int size;
+} ArtTree;
+
+unsigned int artKey(int id) {
+    return (unsigned int)id ^ 0x80000000u;
+}
+
+unsigned char artByte(unsigned int key, int depth) {
+    return (unsigned char)(key >> (24 - 8 * depth));
+}
+
+ArtNode* art_newNode(int type) {
+    size_t bytes;
+    switch (type) {
+        case ART_NODE4: bytes = sizeof(ArtNode4); break;
+        case ART_NODE16: bytes = sizeof(ArtNode16); break;
+        case ART_NODE48: bytes = sizeof(ArtNode48); break;
+        default: bytes = sizeof(ArtNode256); break;
+    }
+    ArtNode* node = (ArtNode*)calloc(1, bytes);
+    if (node == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    node->type = (unsigned char)type;
+    return node;
+}
+
+void art_copyHeader(ArtNode* dest, ArtNode* src) {
+    dest->numChildren = src->numChildren;
+    dest->prefixLen = src->prefixLen;
+    memcpy(dest->prefix, src->prefix, sizeof(src->prefix));
+}
+
+void** art_findChild(ArtNode* node, unsigned char b) {
+    switch (node->type) {
+        case ART_NODE4: {
+            ArtNode4* n = (ArtNode4*)node;
+            for (int i = 0; i < n->n.numChildren; i++)
+                if (n->keys[i] == b)
+                    return &n->children[i];
+            return NULL;
+        }
+        case ART_NODE16: {
+            ArtNode16* n = (ArtNode16*)node;
+#ifdef __SSE2__
+            __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)b), _mm_loadu_si128((__m128i*)n->keys));
+            int bits = _mm_movemask_epi8(cmp) & ((1 << n->n.numChildren) - 1);
+            return bits ? &n->children[__builtin_ctz(bits)] : NULL;
+#else
+            for (int i = 0; i < n->n.numChildren; i++)
+                if (n->keys[i] == b)
+                    return &n->children[i];
+            return NULL;
+#endif
+        }
+        case ART_NODE48: {
+            ArtNode48* n = (ArtNode48*)node;
+            return n->childIndex[b] ? &n->children[n->childIndex[b] - 1] : NULL;
+        }
+        default: {
+            ArtNode256* n = (ArtNode256*)node;
+            return n->children[b] ? &n->children[b] : NULL;
+        }
+    }
+}
+
+ArtLeaf* art_search(ArtTree* tree, int id) {
+    unsigned int key = artKey(id);
+    void* n = tree->root;
+    int depth = 0;
+    while (n != NULL) {
+        if (ART_IS_LEAF(n)) {
+            ArtLeaf* leaf = ART_LEAF(n);
+            return leaf->key == key ? leaf : NULL;
+        }
+        ArtNode* node = (ArtNode*)n;
+        for (int i = 0; i < node->prefixLen; i++)
+            if (node->prefix[i] != artByte(key, depth + i))
+                return NULL;
+        depth += node->prefixLen;
+        void** child = art_findChild(node, artByte(key, depth));
+        n = child ? *child : NULL;
+        depth++;
+    }
+    return NULL;
+}
+
+void art_addChild(ArtNode* node, void** ref, unsigned char b, void* child);
+
+void art_addChild4(ArtNode4* n, void** ref, unsigned char b, void* child) {
+    if (n->n.numChildren < 4) {
+        int i = 0;
+        while (i < n->n.numChildren && n->keys[i] < b)
+            i++;
+        memmove(n->keys + i + 1, n->keys + i, n->n.numChildren - i);
+        memmove(n->children + i + 1, n->children + i, (n->n.numChildren - i) * sizeof(void*));
+        n->keys[i] = b;
+        n->children[i] = child;
+        n->n.numChildren++;
+        return;
+    }
+    ArtNode16* bigger = (ArtNode16*)art_newNode(ART_NODE16);
+    art_copyHeader(&bigger->n, &n->n);
+    memcpy(bigger->keys, n->keys, 4);
+    memcpy(bigger->children, n->children, 4 * sizeof(void*));
+    *ref = bigger;
+    free(n);
+    art_addChild(&bigger->n, ref, b, child);
+}
+
+void art_addChild16(ArtNode16* n, void** ref, unsigned char b, void* child) {
+    if (n->n.numChildren < 16) {
+        int i = 0;
+        while (i < n->n.numChildren && n->keys[i] < b)
+            i++;
+        memmove(n->keys + i + 1, n->keys + i, n->n.numChildren - i);
+        memmove(n->children + i + 1, n->children + i, (n->n.numChildren - i) * sizeof(void*));
+        n->keys[i] = b;
+        n->children[i] = child;
+        n->n.numChildren++;
+        return;
+    }
+    ArtNode48* bigger = (ArtNode48*)art_newNode(ART_NODE48);
+    art_copyHeader(&bigger->n, &n->n);
+    for (int i = 0; i < 16; i++) {
+        bigger->children[i] = n->children[i];
+        bigger->childIndex[n->keys[i]] = (unsigned char)(i + 1);
+    }
+    *ref = bigger;
+    free(n);
+    art_addChild(&bigger->n, ref, b, child);
+}
+
+void art_addChild48(ArtNode48* n, void** ref, unsigned char b, void* child) {
+    if (n->n.numChildren < 48) {
+        int slot = 0;
+        while (n->children[slot] != NULL)
+            slot++;
+        n->children[slot] = child;
+        n->childIndex[b] = (unsigned char)(slot + 1);
+        n->n.numChildren++;
+        return;
+    }
+    ArtNode256* bigger = (ArtNode256*)art_newNode(ART_NODE256);
+    art_copyHeader(&bigger->n, &n->n);
+    for (int i = 0; i < 256; i++)
+        if (n->childIndex[i])
+            bigger->children[i] = n->children[n->childIndex[i] - 1];
+    *ref = bigger;
+    free(n);
+    art_addChild(&bigger->n, ref, b, child);
+}
+
+void art_addChild(ArtNode* node, void** ref, unsigned char b, void* child) {
+    switch (node->type) {
+        case ART_NODE4: art_addChild4((ArtNode4*)node, ref, b, child); break;
+        case ART_NODE16: art_addChild16((ArtNode16*)node, ref, b, child); break;
+        case ART_NODE48: art_addChild48((ArtNode48*)node, ref, b, child); break;
+        default: {
+            ArtNode256* n = (ArtNode256*)node;
+            n->children[b] = child;
+            n->n.numChildren++;
+        }
+    }
+}
+
+void art_insertRec(void** ref, unsigned int key, int depth, ArtLeaf* leaf) {
+    void* n = *ref;
+    if (n == NULL) {
+        *ref = ART_TAG_LEAF(leaf);
+        return;
+    }
+    if (ART_IS_LEAF(n)) {
+        ArtLeaf* existing = ART_LEAF(n);
+        ArtNode* split = art_newNode(ART_NODE4);
+        int lcp = 0;
+        while (artByte(existing->key, depth + lcp) == artByte(key, depth + lcp)) {
+            split->prefix[lcp] = artByte(key, depth + lcp);
+            lcp++;
+        }
+        split->prefixLen = (unsigned char)lcp;
+        depth += lcp;
+        *ref = split;
+        art_addChild(split, ref, artByte(existing->key, depth), n);
+        art_addChild(split, ref, artByte(key, depth), ART_TAG_LEAF(leaf));
+        return;
+    }
+
+    ArtNode* node = (ArtNode*)n;
+    int p = 0;
+    while (p < node->prefixLen && node->prefix[p] == artByte(key, depth + p))
+        p++;
+    if (p < node->prefixLen) {
+        ArtNode* split = art_newNode(ART_NODE4);
+        split->prefixLen = (unsigned char)p;
+        memcpy(split->prefix, node->prefix, p);
+        unsigned char nodeByte = node->prefix[p];
+        node->prefixLen = (unsigned char)(node->prefixLen - p - 1);
+        memmove(node->prefix, node->prefix + p + 1, node->prefixLen);
+        *ref = split;
+        art_addChild(split, ref, nodeByte, node);
+        art_addChild(split, ref, artByte(key, depth + p), ART_TAG_LEAF(leaf));
+        return;
+    }
+    depth += node->prefixLen;
+    void** child = art_findChild(node, artByte(key, depth));
+    if (child != NULL)
+        art_insertRec(child, key, depth + 1, leaf);
+    else
+        art_addChild(node, ref, artByte(key, depth), ART_TAG_LEAF(leaf));
+}
+
+int art_insert(ArtTree* tree, int id, Medicine data) {
+    if (art_search(tree, id) != NULL)
+        return 0;
+    ArtLeaf* leaf = (ArtLeaf*)malloc(sizeof(ArtLeaf));
+    if (leaf == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    leaf->key = artKey(id);
+    leaf->medicineID = id;
+    leaf->data = data;
+    art_insertRec(&tree->root, leaf->key, 0, leaf);
+    tree->size++;
+    return 1;
+}
+
+void art_removeChild(ArtNode* node, void** ref, unsigned char b, void** slot) {
+    switch (node->type) {
+        case ART_NODE4: {
+            ArtNode4* n = (ArtNode4*)node;
+            int i = (int)(slot - n->children);
+            memmove(n->keys + i, n->keys + i + 1, n->n.numChildren - 1 - i);
+            memmove(n->children + i, n->children + i + 1, (n->n.numChildren - 1 - i) * sizeof(void*));
+            n->n.numChildren--;
+            if (n->n.numChildren == 1) {
+                void* only = n->children[0];
+                if (!ART_IS_LEAF(only)) {
+                    ArtNode* child = (ArtNode*)only;
+                    unsigned char merged[4];
+                    int len = n->n.prefixLen;
+                    memcpy(merged, n->n.prefix, len);
+                    merged[len++] = n->keys[0];
+                    memcpy(merged + len, child->prefix, child->prefixLen);
+                    len += child->prefixLen;
+                    memcpy(child->prefix, merged, len);
+                    child->prefixLen = (unsigned char)len;
+                }
+                *ref = only;
+                free(n);
+            }
+            return;
+        }
+        case ART_NODE16: {
+            ArtNode16* n = (ArtNode16*)node;
+            int i = (int)(slot - n->children);
+            memmove(n->keys + i, n->keys + i + 1, n->n.numChildren - 1 - i);
+            memmove(n->children + i, n->children + i + 1, (n->n.numChildren - 1 - i) * sizeof(void*));
+            n->n.numChildren--;
+            if (n->n.numChildren == 3) {
+                ArtNode4* smaller = (ArtNode4*)art_newNode(ART_NODE4);
+                art_copyHeader(&smaller->n, &n->n);
+                memcpy(smaller->keys, n->keys, 3);
+                memcpy(smaller->children, n->children, 3 * sizeof(void*));
+                *ref = smaller;
+                free(n);
+            }
+            return;
+        }
+        case ART_NODE48: {
+            ArtNode48* n = (ArtNode48*)node;
+            n->children[n->childIndex[b] - 1] = NULL;
+            n->childIndex[b] = 0;
+            n->n.numChildren--;
+            if (n->n.numChildren == 12) {
+                ArtNode16* smaller = (ArtNode16*)art_newNode(ART_NODE16);
+                art_copyHeader(&smaller->n, &n->n);
+                int count = 0;
+                for (int i = 0; i < 256; i++)
+                    if (n->childIndex[i]) {
+                        smaller->keys[count] = (unsigned char)i;
+                        smaller->children[count++] = n->children[n->childIndex[i] - 1];
+                    }
+                *ref = smaller;
+                free(n);
+            }
+            return;
+        }
+        default: {
+            ArtNode256* n = (ArtNode256*)node;
+            n->children[b] = NULL;
+            n->n.numChildren--;
+            if (n->n.numChildren == 37) {
+                ArtNode48* smaller = (ArtNode48*)art_newNode(ART_NODE48);
+                art_copyHeader(&smaller->n, &n->n);
+                int count = 0;
+                for (int i = 0; i < 256; i++)
+                    if (n->children[i]) {
+                        smaller->children[count] = n->children[i];
+                        smaller->childIndex[i] = (unsigned char)(++count);
+                    }
+                *ref = smaller;
+                free(n);
+            }
+        }
+    }
+}
+
+int art_deleteRec(void** ref, unsigned int key, int depth) {
+    void* n = *ref;
+    if (n == NULL)
+        return 0;
+    if (ART_IS_LEAF(n)) {
+        if (ART_LEAF(n)->key != key)
+            return 0;
+        free(ART_LEAF(n));
+        *ref = NULL;
+        return 1;
+    }
+    ArtNode* node = (ArtNode*)n;
+    for (int i = 0; i < node->prefixLen; i++)
+        if (node->prefix[i] != artByte(key, depth + i))
+            return 0;
+    depth += node->prefixLen;
+    unsigned char b = artByte(key, depth);
+    void** child = art_findChild(node, b);
+    if (child == NULL)
+        return 0;
+    if (ART_IS_LEAF(*child)) {
+        if (ART_LEAF(*child)->key != key)
+            return 0;
+        free(ART_LEAF(*child));
+        art_removeChild(node, ref, b, child);
+        return 1;
+    }
+    return art_deleteRec(child, key, depth + 1);
+}
+
+int art_delete(ArtTree* tree, int id) {
+    if (art_deleteRec(&tree->root, artKey(id), 0)) {
+        tree->size--;
+        return 1;
+    }
+    return 0;
+}
+
+typedef void (*VisitFn)(int id, Medicine* data, void* ctx);
+
+void art_forEachRec(void* n, VisitFn visit, void* ctx) {
+    if (n == NULL)
+        return;
+    if (ART_IS_LEAF(n)) {
+        ArtLeaf* leaf = ART_LEAF(n);
+        visit(leaf->medicineID, &leaf->data, ctx);
+        return;
+    }
+    ArtNode* node = (ArtNode*)n;
+    switch (node->type) {
+        case ART_NODE4: {
+            ArtNode4* a = (ArtNode4*)node;
+            for (int i = 0; i < a->n.numChildren; i++)
+                art_forEachRec(a->children[i], visit, ctx);
+            break;
+        }
+        case ART_NODE16: {
+            ArtNode16* a = (ArtNode16*)node;
+            for (int i = 0; i < a->n.numChildren; i++)
+                art_forEachRec(a->children[i], visit, ctx);
+            break;
+        }
+        case ART_NODE48: {
+            ArtNode48* a = (ArtNode48*)node;
+            for (int i = 0; i < 256; i++)
+                if (a->childIndex[i])
+                    art_forEachRec(a->children[a->childIndex[i] - 1], visit, ctx);
+            break;
+        }
+        default: {
+            ArtNode256* a = (ArtNode256*)node;
+            for (int i = 0; i < 256; i++)
+                art_forEachRec(a->children[i], visit, ctx);
+        }
+    }
+}
+
+void art_forEach(ArtTree* tree, VisitFn visit, void* ctx) {
+    art_forEachRec(tree->root, visit, ctx);
+}
+
+void art_freeRec(void* n) {
+    if (n == NULL)
+        return;
+    if (ART_IS_LEAF(n)) {
+        free(ART_LEAF(n));
+        return;
+    }
+    ArtNode* node = (ArtNode*)n;
+    switch (node->type) {
+        case ART_NODE4:
+            for (int i = 0; i < node->numChildren; i++)
+                art_freeRec(((ArtNode4*)node)->children[i]);
+            break;
+        case ART_NODE16:
+            for (int i = 0; i < node->numChildren; i++)
+                art_freeRec(((ArtNode16*)node)->children[i]);
+            break;
+        case ART_NODE48:
+            for (int i = 0; i < 48; i++)
+                art_freeRec(((ArtNode48*)node)->children[i]);
+            break;
+        default:
+            for (int i = 0; i < 256; i++)
+                art_freeRec(((ArtNode256*)node)->children[i]);
+    }
+    free(node);
+}
+
+void art_free(ArtTree* tree) {
+    art_freeRec(tree->root);
+    tree->root = NULL;
+    tree->size = 0;
+}
+
+void treeForEach(Node* root, VisitFn visit, void* ctx) {
+    Node *current = root, *pre;
+    while (current != NULL) {
+        if (current->left == NULL) {
+            visit(current->medicineID, &current->data, ctx);
+            current = current->right;
+        } else {
+            pre = current->left;
+            while (pre->right != NULL && pre->right != current)
+                pre = pre->right;
+
+            if (pre->right == NULL) {
+                pre->right = current;
+                current = current->left;
+            } else {
+                pre->right = NULL;
+                visit(current->medicineID, &current->data, ctx);
+                current = current->right;
+            }
+        }
+    }
+}
+
+typedef struct InventoryEngine {
+    const char* name;
+    void* (*create)();
+    int (*insert)(void* store, int id, Medicine data);
+    int (*remove)(void* store, int id);
+    Medicine* (*find)(void* store, int id);
+    void (*forEach)(void* store, VisitFn visit, void* ctx);
+    void (*destroy)(void* store);
+    int (*height)(void* store);
+    size_t (*memoryBytes)(void* store);
+} InventoryEngine;
+
+void* treeEngine_create() {
+    Node** root = (Node**)malloc(sizeof(Node*));
+    *root = NULL;
+    return root;
+}
+
+int bstEngine_insert(void* store, int id, Medicine data) {
+    Node** root = (Node**)store;
+    if (findNode(*root, id) != NULL)
+        return 0;
+    *root = bst_insert(*root, id, data);
+    return 1;
+}
+
+int bstEngine_remove(void* store, int id) {
+    Node** root = (Node**)store;
+    if (findNode(*root, id) == NULL)
+        return 0;
+    *root = bst_delete(*root, id);
+    return 1;
+}
+
+int avlEngine_insert(void* store, int id, Medicine data) {
+    Node** root = (Node**)store;
+    if (findNode(*root, id) != NULL)
+        return 0;
+    *root = avl_insert(*root, id, data);
+    return 1;
+}
+
+int avlEngine_remove(void* store, int id) {
+    Node** root = (Node**)store;
+    if (findNode(*root, id) == NULL)
+        return 0;
+    *root = avl_delete(*root, id);
+    return 1;
+}
+
+Medicine* treeEngine_find(void* store, int id) {
+    Node* found = search(*(Node**)store, id);
+    return found ? &found->data : NULL;
+}
+
+void treeEngine_forEach(void* store, VisitFn visit, void* ctx) {
+    treeForEach(*(Node**)store, visit, ctx);
+}
+
+void treeEngine_destroy(void* store) {
+    freeTree(*(Node**)store);
+    free(store);
+}
+
+void* artEngine_create() {
+    return calloc(1, sizeof(ArtTree));
+}
+
+int artEngine_insert(void* store, int id, Medicine data) {
+    return art_insert((ArtTree*)store, id, data);
+}
+
+int artEngine_remove(void* store, int id) {
+    return art_delete((ArtTree*)store, id);
+}
+
+Medicine* artEngine_find(void* store, int id) {
+    ArtLeaf* leaf = art_search((ArtTree*)store, id);
+    return leaf ? &leaf->data : NULL;
+}
+
+void artEngine_forEach(void* store, VisitFn visit, void* ctx) {
+    art_forEach((ArtTree*)store, visit, ctx);
+}
+
+void artEngine_destroy(void* store) {
+    art_free((ArtTree*)store);
+    free(store);
+}
+
+int treeEngine_height(void* store) {
+    return height(*(Node**)store);
+}
+
+size_t treeEngine_memoryBytes(void* store) {
+    return (size_t)nodeSize(*(Node**)store) * sizeof(Node);
+}
+
+void art_statsRec(void* n, int depth, size_t* bytes, int* maxDepth) {
+    if (n == NULL)
+        return;
+    if (depth > *maxDepth)
+        *maxDepth = depth;
+    if (ART_IS_LEAF(n)) {
+        *bytes += sizeof(ArtLeaf);
+        return;
+    }
+    ArtNode* node = (ArtNode*)n;
+    switch (node->type) {
+        case ART_NODE4:
+            *bytes += sizeof(ArtNode4);
+            for (int i = 0; i < node->numChildren; i++)
+                art_statsRec(((ArtNode4*)node)->children[i], depth + 1, bytes, maxDepth);
+            break;
+        case ART_NODE16:
+            *bytes += sizeof(ArtNode16);
+            for (int i = 0; i < node->numChildren; i++)
+                art_statsRec(((ArtNode16*)node)->children[i], depth + 1, bytes, maxDepth);
+            break;
+        case ART_NODE48:
+            *bytes += sizeof(ArtNode48);
+            for (int i = 0; i < 48; i++)
+                art_statsRec(((ArtNode48*)node)->children[i], depth + 1, bytes, maxDepth);
+            break;
+        default:
+            *bytes += sizeof(ArtNode256);
+            for (int i = 0; i < 256; i++)
+                art_statsRec(((ArtNode256*)node)->children[i], depth + 1, bytes, maxDepth);
+    }
+}
+
+int artEngine_height(void* store) {
+    size_t bytes = 0;
+    int depth = 0;
+    art_statsRec(((ArtTree*)store)->root, 1, &bytes, &depth);
+    return depth;
+}
+
+size_t artEngine_memoryBytes(void* store) {
+    size_t bytes = 0;
+    int depth = 0;
+    art_statsRec(((ArtTree*)store)->root, 1, &bytes, &depth);
+    return bytes;
+}
+
+typedef struct TreapNode {
+    int medicineID;
+    Medicine data;
+    unsigned int priority;
+    struct TreapNode *left;
+    struct TreapNode *right;
+} TreapNode;
+
+typedef struct Treap {
+    TreapNode* root;
+    int size;
+    unsigned int seed;
+} Treap;
+
+TreapNode* treap_rightRotate(TreapNode* y) {
+    TreapNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    STAT_INC(rotations);
+    return x;
+}
+
+TreapNode* treap_leftRotate(TreapNode* x) {
+    TreapNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    STAT_INC(rotations);
+    return y;
+}
+
+TreapNode* treap_insertRec(Treap* t, TreapNode* root, int id, Medicine data, int* inserted) {
+    if (root == NULL) {
+        TreapNode* node = (TreapNode*)malloc(sizeof(TreapNode));
+        if (node == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+        node->medicineID = id;
+        node->data = data;
+        node->priority = nextRandom(&t->seed);
+        node->left = node->right = NULL;
+        *inserted = 1;
+        return node;
+    }
+    if (id < root->medicineID) {
+        root->left = treap_insertRec(t, root->left, id, data, inserted);
+        if (root->left->priority > root->priority)
+            root = treap_rightRotate(root);
+    } else if (id > root->medicineID) {
+        root->right = treap_insertRec(t, root->right, id, data, inserted);
+        if (root->right->priority > root->priority)
+            root = treap_leftRotate(root);
+    }
+    return root;
+}
+
+TreapNode* treap_deleteRec(TreapNode* root, int id, int* removed) {
+    if (root == NULL)
+        return NULL;
+    if (id < root->medicineID) {
+        root->left = treap_deleteRec(root->left, id, removed);
+    } else if (id > root->medicineID) {
+        root->right = treap_deleteRec(root->right, id, removed);
+    } else if (root->left == NULL || root->right == NULL) {
+        TreapNode* child = root->left ? root->left : root->right;
+        free(root);
+        *removed = 1;
+        return child;
+    } else if (root->left->priority > root->right->priority) {
+        root = treap_rightRotate(root);
+        root->right = treap_deleteRec(root->right, id, removed);
+    } else {
+        root = treap_leftRotate(root);
+        root->left = treap_deleteRec(root->left, id, removed);
+    }
+    return root;
+}
+
+int treap_heightRec(TreapNode* n) {
+    if (n == NULL)
+        return 0;
+    return 1 + max(treap_heightRec(n->left), treap_heightRec(n->right));
+}
+
+void treap_forEachRec(TreapNode* n, VisitFn visit, void* ctx) {
+    if (n == NULL)
+        return;
+    treap_forEachRec(n->left, visit, ctx);
+    visit(n->medicineID, &n->data, ctx);
+    treap_forEachRec(n->right, visit, ctx);
+}
+
+void treap_freeRec(TreapNode* n) {
+    if (n == NULL)
+        return;
+    treap_freeRec(n->left);
+    treap_freeRec(n->right);
+    free(n);
+}
+
+void* treapEngine_create() {
+    Treap* t = (Treap*)calloc(1, sizeof(Treap));
+    t->seed = 0xC0FFEEu;
+    return t;
+}
+
+int treapEngine_insert(void* store, int id, Medicine data) {
+    Treap* t = (Treap*)store;
+    int inserted = 0;
+    t->root = treap_insertRec(t, t->root, id, data, &inserted);
+    t->size += inserted;
+    return inserted;
+}
+
+int treapEngine_remove(void* store, int id) {
+    Treap* t = (Treap*)store;
+    int removed = 0;
+    t->root = treap_deleteRec(t->root, id, &removed);
+    t->size -= removed;
+    return removed;
+}
+
+Medicine* treapEngine_find(void* store, int id) {
+    TreapNode* n = ((Treap*)store)->root;
+    while (n != NULL && n->medicineID != id)
+        n = (id < n->medicineID) ? n->left : n->right;
+    return n ? &n->data : NULL;
+}
+
+void treapEngine_forEach(void* store, VisitFn visit, void* ctx) {
+    treap_forEachRec(((Treap*)store)->root, visit, ctx);
+}
+
+void treapEngine_destroy(void* store) {
+    treap_freeRec(((Treap*)store)->root);
+    free(store);
+}
+
+int treapEngine_height(void* store) {
+    return treap_heightRec(((Treap*)store)->root);
+}
+
+size_t treapEngine_memoryBytes(void* store) {
+    return (size_t)((Treap*)store)->size * sizeof(TreapNode);
+}
+
+#define SKIP_MAX_LEVEL 32
+
+typedef struct SkipNode {
+    int medicineID;
+    Medicine data;
+    int level;
+    struct SkipNode* forward[1];
+} SkipNode;
+
+typedef struct SkipList {
+    SkipNode* head;
+    int level;
+    int size;
+    unsigned int seed;
+    size_t bytes;
+} SkipList;
+
+SkipNode* skip_newNode(SkipList* list, int level) {
+    size_t bytes = sizeof(SkipNode) + (level - 1) * sizeof(SkipNode*);
+    SkipNode* node = (SkipNode*)calloc(1, bytes);
+    if (node == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    node->level = level;
+    list->bytes += bytes;
+    return node;
+}
+
+void* skipEngine_create() {
+    SkipList* list = (SkipList*)calloc(1, sizeof(SkipList));
+    list->seed = 0xBADC0DEu;
+    list->level = 1;
+    list->head = skip_newNode(list, SKIP_MAX_LEVEL);
+    return list;
+}
+
+int skipEngine_insert(void* store, int id, Medicine data) {
+    SkipList* list = (SkipList*)store;
+    SkipNode* update[SKIP_MAX_LEVEL];
+    SkipNode* x = list->head;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->forward[i] != NULL && x->forward[i]->medicineID < id)
+            x = x->forward[i];
+        update[i] = x;
+    }
+    if (x->forward[0] != NULL && x->forward[0]->medicineID == id)
+        return 0;
+
+    int level = 1 + __builtin_ctz(nextRandom(&list->seed) | (1u << (SKIP_MAX_LEVEL - 1)));
+    if (level > list->level) {
+        for (int i = list->level; i < level; i++)
+            update[i] = list->head;
+        list->level = level;
+    }
+    SkipNode* node = skip_newNode(list, level);
+    node->medicineID = id;
+    node->data = data;
+    for (int i = 0; i < level; i++) {
+        node->forward[i] = update[i]->forward[i];
+        update[i]->forward[i] = node;
+    }
+    list->size++;
+    return 1;
+}
+
+int skipEngine_remove(void* store, int id) {
+    SkipList* list = (SkipList*)store;
+    SkipNode* update[SKIP_MAX_LEVEL];
+    SkipNode* x = list->head;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->forward[i] != NULL && x->forward[i]->medicineID < id)
+            x = x->forward[i];
+        update[i] = x;
+    }
+    x = x->forward[0];
+    if (x == NULL || x->medicineID != id)
+        return 0;
+    for (int i = 0; i < x->level; i++)
+        update[i]->forward[i] = x->forward[i];
+    while (list->level > 1 && list->head->forward[list->level - 1] == NULL)
+        list->level--;
+    list->bytes -= sizeof(SkipNode) + (x->level - 1) * sizeof(SkipNode*);
+    free(x);
+    list->size--;
+    return 1;
+}
+
+Medicine* skipEngine_find(void* store, int id) {
+    SkipList* list = (SkipList*)store;
+    SkipNode* x = list->head;
+    for (int i = list->level - 1; i >= 0; i--)
+        while (x->forward[i] != NULL && x->forward[i]->medicineID < id)
+            x = x->forward[i];
+    x = x->forward[0];
+    return (x != NULL && x->medicineID == id) ? &x->data : NULL;
+}
+
+void skipEngine_forEach(void* store, VisitFn visit, void* ctx) {
+    for (SkipNode* x = ((SkipList*)store)->head->forward[0]; x != NULL; x = x->forward[0])
+        visit(x->medicineID, &x->data, ctx);
+}
+
+void skipEngine_destroy(void* store) {
+    SkipList* list = (SkipList*)store;
+    SkipNode* x = list->head;
+    while (x != NULL) {
+        SkipNode* next = x->forward[0];
+        free(x);
+        x = next;
+    }
+    free(list);
+}
+
+int skipEngine_height(void* store) {
+    return ((SkipList*)store)->level;
+}
+
+size_t skipEngine_memoryBytes(void* store) {
+    return ((SkipList*)store)->bytes;
+}
+
+InventoryEngine bstEngine = {"BST", treeEngine_create, bstEngine_insert, bstEngine_remove,
+                             treeEngine_find, treeEngine_forEach, treeEngine_destroy,
+                             treeEngine_height, treeEngine_memoryBytes};
+InventoryEngine avlEngine = {"AVL", treeEngine_create, avlEngine_insert, avlEngine_remove,
+                             treeEngine_find, treeEngine_forEach, treeEngine_destroy,
+                             treeEngine_height, treeEngine_memoryBytes};
+InventoryEngine artEngine = {"ART", artEngine_create, artEngine_insert, artEngine_remove,
+                             artEngine_find, artEngine_forEach, artEngine_destroy,
+                             artEngine_height, artEngine_memoryBytes};
+InventoryEngine treapEngine = {"Treap", treapEngine_create, treapEngine_insert, treapEngine_remove,
+                               treapEngine_find, treapEngine_forEach, treapEngine_destroy,
+                               treapEngine_height, treapEngine_memoryBytes};
+InventoryEngine skipEngine = {"Skip", skipEngine_create, skipEngine_insert, skipEngine_remove,
+                              skipEngine_find, skipEngine_forEach, skipEngine_destroy,
+                              skipEngine_height, skipEngine_memoryBytes};
+
+typedef struct PoolTask {
+    void (*run)(void* arg);
+    void* arg;
+    int done;
+} PoolTask;
+
+typedef struct ThreadPool {
+    pthread_t* workers;
+    int numWorkers;
+    PoolTask** tasks;
+    int count;
+    int capacity;
+    int shutdown;
+    pthread_mutex_t lock;
+    pthread_cond_t hasWork;
+} ThreadPool;
+
+PoolTask* pool_pop(ThreadPool* pool) {
+    PoolTask* task = NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->count > 0)
+        task = pool->tasks[--pool->count];
+    pthread_mutex_unlock(&pool->lock);
+    return task;
+}
+
+void pool_runTask(PoolTask* task) {
+    task->run(task->arg);
+    __atomic_store_n(&task->done, 1, __ATOMIC_RELEASE);
+}
+
+void* pool_worker(void* arg) {
+    ThreadPool* pool = (ThreadPool*)arg;
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->count == 0 && !pool->shutdown)
+            pthread_cond_wait(&pool->hasWork, &pool->lock);
+        if (pool->count == 0) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        PoolTask* task = pool->tasks[--pool->count];
+        pthread_mutex_unlock(&pool->lock);
+        pool_runTask(task);
+    }
+}
+
+ThreadPool* pool_create(int numWorkers) {
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+    pool->numWorkers = numWorkers;
+    pool->capacity = 256;
+    pool->tasks = (PoolTask**)malloc(pool->capacity * sizeof(PoolTask*));
+    pool->workers = (pthread_t*)malloc(numWorkers * sizeof(pthread_t));
+    if (pool->tasks == NULL || pool->workers == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->hasWork, NULL);
+    for (int i = 0; i < numWorkers; i++)
+        pthread_create(&pool->workers[i], NULL, pool_worker, pool);
+    return pool;
+}
+
+void pool_submit(ThreadPool* pool, PoolTask* task) {
+    task->done = 0;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->count == pool->capacity) {
+        pool->capacity *= 2;
+        pool->tasks = (PoolTask**)realloc(pool->tasks, pool->capacity * sizeof(PoolTask*));
+        if (pool->tasks == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    pool->tasks[pool->count++] = task;
+    pthread_cond_signal(&pool->hasWork);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_wait(ThreadPool* pool, PoolTask* task) {
+    while (!__atomic_load_n(&task->done, __ATOMIC_ACQUIRE)) {
+        PoolTask* other = pool_pop(pool);
+        if (other != NULL)
+            pool_runTask(other);
+        else
+            sched_yield();
+    }
+}
+
+void pool_destroy(ThreadPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->hasWork);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->numWorkers; i++)
+        pthread_join(pool->workers[i], NULL);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->hasWork);
+    free(pool->workers);
+    free(pool->tasks);
+    free(pool);
+}
+
+Node* joinRight(Node* tl, Node* k, Node* tr) {
+    Node* l = tl->left;
+    Node* c = tl->right;
+    if (height(c) <= height(tr) + 1) {
+        k->left = c;
+        k->right = tr;
+        updateHeight(k);
+        if (height(k) <= height(l) + 1) {
+            tl->right = k;
+            updateHeight(tl);
+            return tl;
+        }
+        tl->right = rightRotate(k);
+        updateHeight(tl);
+        return leftRotate(tl);
+    }
+    Node* t = joinRight(c, k, tr);
+    tl->right = t;
+    updateHeight(tl);
+    if (height(t) <= height(l) + 1)
+        return tl;
+    return leftRotate(tl);
+}
+
+Node* joinLeft(Node* tl, Node* k, Node* tr) {
+    Node* r = tr->right;
+    Node* c = tr->left;
+    if (height(c) <= height(tl) + 1) {
+        k->left = tl;
+        k->right = c;
+        updateHeight(k);
+        if (height(k) <= height(r) + 1) {
+            tr->left = k;
+            updateHeight(tr);
+            return tr;
+        }
+        tr->left = leftRotate(k);
+        updateHeight(tr);
+        return rightRotate(tr);
+    }
+    Node* t = joinLeft(tl, k, c);
+    tr->left = t;
+    updateHeight(tr);
+    if (height(t) <= height(r) + 1)
+        return tr;
+    return rightRotate(tr);
+}
+
+Node* avl_join(Node* tl, Node* k, Node* tr) {
+    if (height(tl) > height(tr) + 1)
+        return joinRight(tl, k, tr);
+    if (height(tr) > height(tl) + 1)
+        return joinLeft(tl, k, tr);
+    k->left = tl;
+    k->right = tr;
+    updateHeight(k);
+    return k;
+}
+
+void avl_split(Node* t, int id, Node** left, Node** mid, Node** right) {
+    if (t == NULL) {
+        *left = *mid = *right = NULL;
+        return;
+    }
+    Node* l = t->left;
+    Node* r = t->right;
+    if (id == t->medicineID) {
+        t->left = t->right = NULL;
+        updateHeight(t);
+        *left = l;
+        *mid = t;
+        *right = r;
+    } else if (id < t->medicineID) {
+        Node* rest;
+        avl_split(l, id, left, mid, &rest);
+        *right = avl_join(rest, t, r);
+    } else {
+        Node* rest;
+        avl_split(r, id, &rest, mid, right);
+        *left = avl_join(l, t, rest);
+    }
+}
+
+Node* splitLast(Node* t, Node** last) {
+    if (t->right == NULL) {
+        Node* l = t->left;
+        t->left = NULL;
+        updateHeight(t);
+        *last = t;
+        return l;
+    }
+    Node* rest = splitLast(t->right, last);
+    return avl_join(t->left, t, rest);
+}
+
+Node* avl_join2(Node* tl, Node* tr) {
+    if (tl == NULL)
+        return tr;
+    Node* k;
+    Node* rest = splitLast(tl, &k);
+    return avl_join(rest, k, tr);
+}
+
+int adjustStock(Node* root, int id, int delta) {
+    if (root == NULL)
+        return 0;
+    int found;
+    if (id == root->medicineID) {
+        root->data.quantity += delta;
+        found = 1;
+    } else {
+        found = adjustStock(id < root->medicineID ? root->left : root->right, id, delta);
+    }
+    if (found)
+        updateHeight(root);
+    return found;
+}
+
+void releaseNode(Node* n) {
+    free(n);
+    STAT_INC(frees);
+}
+
+#define SET_UNION 0
+#define SET_INTERSECTION 1
+#define SET_DIFFERENCE 2
+#define SET_PARALLEL_CUTOFF 4096
+#define SET_BATCH_CUTOFF 16
+
+// Set operations reuse the nodes of both input trees for the result; pass
+// copyTree() results to keep the originals. Whole subtrees that drop out of
+// the result are not freed here (that would cost O(n)); their roots are
+// appended to `dropped` for the caller to release with freeDropped().
+Node* setOperation(int op, Node* a, Node* b, ThreadPool* pool, RetireList* dropped);
+
+typedef struct SetOpTask {
+    PoolTask task;
+    int op;
+    Node* a;
+    Node* b;
+    Node* result;
+    ThreadPool* pool;
+    RetireList dropped;
+} SetOpTask;
+
+void runSetOpTask(void* arg) {
+    SetOpTask* t = (SetOpTask*)arg;
+    t->result = setOperation(t->op, t->a, t->b, t->pool, &t->dropped);
+}
+
+void dropSubtree(RetireList* dropped, Node* t) {
+    if (t != NULL)
+        retire(dropped, t);
+}
+
+void freeDropped(RetireList* dropped) {
+    for (int i = 0; i < dropped->count; i++)
+        freeTree((Node*)dropped->items[i]);
+    free(dropped->items);
+    dropped->items = NULL;
+    dropped->count = dropped->capacity = 0;
+}
+
+// Once b is down to a few items, the rest is one searchBatch() over a: the
+// lookups walk a together instead of splitting b and re-joining pieces of a
+// at every level, and their cache misses overlap.
+Node* setOperationSmall(int op, Node* a, Node* b, RetireList* dropped) {
+    Node* items[SET_BATCH_CUTOFF];
+    Node* found[SET_BATCH_CUTOFF];
+    int ids[SET_BATCH_CUTOFF] = {0};
+    int k = flattenInorder(b, items);
+    for (int i = 0; i < k; i++)
+        ids[i] = items[i]->medicineID;
+    searchBatch(a, ids, k, found);
+
+    if (op == SET_INTERSECTION) {
+        int kept = 0;
+        for (int i = 0; i < k; i++) {
+            if (found[i] != NULL) {
+                items[i]->data = found[i]->data;
+                items[kept++] = items[i];
+            } else {
+                releaseNode(items[i]);
+            }
+        }
+        dropSubtree(dropped, a);
+        return linkBalanced(items, 0, kept - 1);
+    }
+    for (int i = 0; i < k; i++) {
+        if (op == SET_UNION) {
+            if (found[i] != NULL)
+                adjustStock(a, ids[i], items[i]->data.quantity);
+            else
+                a = avl_insert(a, ids[i], items[i]->data);
+        } else if (found[i] != NULL) {
+            a = avl_delete(a, ids[i]);
+        }
+        releaseNode(items[i]);
+    }
+    return a;
+}
+
+// Work is bounded by the smaller input, so only fork when both halves have
+// enough of it; a small branch tree against a huge HQ tree stays sequential.
+int setOpWork(Node* a, Node* b) {
+    return nodeSize(a) < nodeSize(b) ? nodeSize(a) : nodeSize(b);
+}
+
+void setOperationChildren(int op, Node* a1, Node* b1, Node* a2, Node* b2, ThreadPool* pool,
+                          RetireList* dropped, Node** out1, Node** out2) {
+    if (pool != NULL && setOpWork(a1, b1) > SET_PARALLEL_CUTOFF
+                     && setOpWork(a2, b2) > SET_PARALLEL_CUTOFF) {
+        SetOpTask left;
+        left.task.run = runSetOpTask;
+        left.task.arg = &left;
+        left.op = op;
+        left.a = a1;
+        left.b = b1;
+        left.pool = pool;
+        memset(&left.dropped, 0, sizeof(RetireList));
+        pool_submit(pool, &left.task);
+        *out2 = setOperation(op, a2, b2, pool, dropped);
+        pool_wait(pool, &left.task);
+        *out1 = left.result;
+        for (int i = 0; i < left.dropped.count; i++)
+            retire(dropped, left.dropped.items[i]);
+        free(left.dropped.items);
+    } else {
+        *out1 = setOperation(op, a1, b1, pool, dropped);
+        *out2 = setOperation(op, a2, b2, pool, dropped);
+    }
+}
+
+Node* setOperation(int op, Node* a, Node* b, ThreadPool* pool, RetireList* dropped) {
+    if (a == NULL || b == NULL) {
+        if (op == SET_UNION)
+            return a ? a : b;
+        if (op == SET_INTERSECTION) {
+            dropSubtree(dropped, a ? a : b);
+            return NULL;
+        }
+        dropSubtree(dropped, b);
+        return a;
+    }
+    if (nodeSize(b) <= SET_BATCH_CUTOFF)
+        return setOperationSmall(op, a, b, dropped);
+
+    Node *l, *m, *r, *resultLeft, *resultRight;
+    Node* al = a->left;
+    Node* ar = a->right;
+    avl_split(b, a->medicineID, &l, &m, &r);
+    setOperationChildren(op, al, l, ar, r, pool, dropped, &resultLeft, &resultRight);
+
+    if (op == SET_UNION) {
+        if (m != NULL) {
+            a->data.quantity += m->data.quantity;
+            releaseNode(m);
+        }
+        return avl_join(resultLeft, a, resultRight);
+    }
+    // Intersection keeps a's node when b has the ID too, difference when it does not
+    int keep = (m != NULL) == (op == SET_INTERSECTION);
+    if (m != NULL)
+        releaseNode(m);
+    if (keep)
+        return avl_join(resultLeft, a, resultRight);
+    releaseNode(a);
+    return avl_join2(resultLeft, resultRight);
+}
+
+Node* avl_union(Node* a, Node* b, ThreadPool* pool, RetireList* dropped) {
+    return setOperation(SET_UNION, a, b, pool, dropped);
+}
+
+Node* avl_intersection(Node* a, Node* b, ThreadPool* pool, RetireList* dropped) {
+    return setOperation(SET_INTERSECTION, a, b, pool, dropped);
+}
+
+Node* avl_difference(Node* a, Node* b, ThreadPool* pool, RetireList* dropped) {
+    return setOperation(SET_DIFFERENCE, a, b, pool, dropped);
+}
+
+Node* copyTree(Node* root) {
+    if (root == NULL)
+        return NULL;
+    Node* copy = (Node*)malloc(sizeof(Node));
+    STAT_INC(allocations);
+    if (copy == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    *copy = *root;
+    copy->left = copyTree(root->left);
+    copy->right = copyTree(root->right);
+    return copy;
+}
+
+#define MAX_SHARDS 64
+#define ROUTE_BY_HASH 0
+#define ROUTE_BY_RANGE 1
+
+typedef struct InventoryShard {
+    pthread_rwlock_t lock;
+    Node* root;
+    char pad[64];
+} InventoryShard;
+
+typedef struct ShardedInventory {
+    InventoryShard shards[MAX_SHARDS];
+    int numShards;
+    int routing;
+    int minID;
+    long rangeWidth;
+} ShardedInventory;
+
+void sharded_init(ShardedInventory* inv, int numShards, int routing, int minID, int maxID) {
+    inv->numShards = numShards;
+    inv->routing = routing;
+    inv->minID = minID;
+    inv->rangeWidth = ((long)maxID - minID) / numShards + 1;
+    for (int i = 0; i < numShards; i++) {
+        pthread_rwlock_init(&inv->shards[i].lock, NULL);
+        inv->shards[i].root = NULL;
+    }
+}
+
+int sharded_route(ShardedInventory* inv, int id) {
+    if (inv->routing == ROUTE_BY_RANGE) {
+        long shard = ((long)id - inv->minID) / inv->rangeWidth;
+        if (shard < 0)
+            return 0;
+        return shard >= inv->numShards ? inv->numShards - 1 : (int)shard;
+    }
+    return (int)((((unsigned int)id * 2654435761u) >> 16) % (unsigned int)inv->numShards);
+}
+
+int sharded_insert(ShardedInventory* inv, int id, Medicine data) {
+    InventoryShard* shard = &inv->shards[sharded_route(inv, id)];
+    int inserted = 0;
+    pthread_rwlock_wrlock(&shard->lock);
+    if (findNode(shard->root, id) == NULL) {
+        shard->root = avl_insert(shard->root, id, data);
+        inserted = 1;
+    }
+    pthread_rwlock_unlock(&shard->lock);
+    return inserted;
+}
+
+int sharded_delete(ShardedInventory* inv, int id) {
+    InventoryShard* shard = &inv->shards[sharded_route(inv, id)];
+    int deleted = 0;
+    pthread_rwlock_wrlock(&shard->lock);
+    if (findNode(shard->root, id) != NULL) {
+        shard->root = avl_delete(shard->root, id);
+        deleted = 1;
+    }
+    pthread_rwlock_unlock(&shard->lock);
+    return deleted;
+}
+
+int sharded_find(ShardedInventory* inv, int id, Medicine* out) {
+    InventoryShard* shard = &inv->shards[sharded_route(inv, id)];
+    pthread_rwlock_rdlock(&shard->lock);
+    Node* found = search(shard->root, id);
+    if (found != NULL && out != NULL)
+        *out = found->data;
+    pthread_rwlock_unlock(&shard->lock);
+    return found != NULL;
+}
+
+typedef struct TreeIterator {
+    Node* stack[64];
+    int top;
+} TreeIterator;
+
+void iterator_pushLeft(TreeIterator* it, Node* n) {
+    while (n != NULL) {
+        it->stack[it->top++] = n;
+        n = n->left;
+    }
+}
+
+Node* iterator_next(TreeIterator* it) {
+    if (it->top == 0)
+        return NULL;
+    Node* n = it->stack[--it->top];
+    iterator_pushLeft(it, n->right);
+    return n;
+}
+
+void sharded_siftDown(Node** heads, int* heap, int size, int i) {
+    while (1) {
+        int smallest = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < size && heads[heap[l]]->medicineID < heads[heap[smallest]]->medicineID)
+            smallest = l;
+        if (r < size && heads[heap[r]]->medicineID < heads[heap[smallest]]->medicineID)
+            smallest = r;
+        if (smallest == i)
+            return;
+        int t = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = t;
+        i = smallest;
+    }
+}
+
+int sharded_forEachOrdered(ShardedInventory* inv, VisitFn visit, void* ctx) {
+    TreeIterator* its = (TreeIterator*)malloc(inv->numShards * sizeof(TreeIterator));
+    Node* heads[MAX_SHARDS];
+    int heap[MAX_SHARDS];
+    int size = 0, visited = 0;
+
+    for (int i = 0; i < inv->numShards; i++)
+        pthread_rwlock_rdlock(&inv->shards[i].lock);
+    for (int i = 0; i < inv->numShards; i++) {
+        its[i].top = 0;
+        iterator_pushLeft(&its[i], inv->shards[i].root);
+        heads[i] = iterator_next(&its[i]);
+        if (heads[i] != NULL)
+            heap[size++] = i;
+    }
+    for (int i = size / 2 - 1; i >= 0; i--)
+        sharded_siftDown(heads, heap, size, i);
+
+    while (size > 0) {
+        int s = heap[0];
+        visit(heads[s]->medicineID, &heads[s]->data, ctx);
+        visited++;
+        heads[s] = iterator_next(&its[s]);
+        if (heads[s] == NULL)
+            heap[0] = heap[--size];
+        sharded_siftDown(heads, heap, size, 0);
+    }
+    for (int i = inv->numShards - 1; i >= 0; i--)
+        pthread_rwlock_unlock(&inv->shards[i].lock);
+    free(its);
+    return visited;
+}
+
+int sharded_size(ShardedInventory* inv) {
+    int total = 0;
+    for (int i = 0; i < inv->numShards; i++) {
+        pthread_rwlock_rdlock(&inv->shards[i].lock);
+        total += nodeSize(inv->shards[i].root);
+        pthread_rwlock_unlock(&inv->shards[i].lock);
+    }
+    return total;
+}
+
+void sharded_destroy(ShardedInventory* inv) {
+    for (int i = 0; i < inv->numShards; i++) {
+        freeTree(inv->shards[i].root);
+        inv->shards[i].root = NULL;
+        pthread_rwlock_destroy(&inv->shards[i].lock);
+    }
+}
+
+#define SNAPSHOT_MAGIC "MEDSNAP1"
+#define SNAPSHOT_VERSION 1
+
+typedef struct SnapshotHeader {
+    char magic[8];
+    int version;
+    int count;
+    long long keysOffset;
+    long long payloadOffset;
+    long long fileSize;
+} SnapshotHeader;
+
+typedef struct MappedSnapshot {
+    void* base;
+    size_t size;
+    EytzingerIndex view;
+} MappedSnapshot;
+
+long long alignOffset(long long offset) {
+    return (offset + 63) / 64 * 64;
+}
+
+int snapshot_save(Node* root, const char* path) {
+    EytzingerIndex* index = eytz_build(root);
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.version = SNAPSHOT_VERSION;
+    header.count = index->n;
+    header.keysOffset = alignOffset(sizeof(SnapshotHeader));
+    header.payloadOffset = alignOffset(header.keysOffset + (long long)(index->n + 1) * sizeof(int));
+    header.fileSize = header.payloadOffset + (long long)(index->n + 1) * sizeof(Medicine);
+
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL) {
+        eytz_free(index);
+        return 0;
+    }
+    char zeros[64] = {0};
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = ok && fwrite(zeros, 1, header.keysOffset - sizeof(header), fp) == (size_t)(header.keysOffset - sizeof(header));
+    ok = ok && fwrite(index->keys, sizeof(int), index->n + 1, fp) == (size_t)(index->n + 1);
+    long long gap = header.payloadOffset - header.keysOffset - (long long)(index->n + 1) * sizeof(int);
+    ok = ok && fwrite(zeros, 1, gap, fp) == (size_t)gap;
+    ok = ok && fwrite(index->payload, sizeof(Medicine), index->n + 1, fp) == (size_t)(index->n + 1);
+    ok = (fclose(fp) == 0) && ok;
+    eytz_free(index);
+    return ok;
+}
+
+int snapshot_open(const char* path, MappedSnapshot* snap) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SnapshotHeader)) {
+        close(fd);
+        return 0;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return 0;
+
+    const SnapshotHeader* header = (const SnapshotHeader*)base;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, 8) != 0 || header->version != SNAPSHOT_VERSION
+        || header->fileSize != (long long)st.st_size || header->count < 0
+        || header->keysOffset < (long long)sizeof(SnapshotHeader) || header->keysOffset > header->fileSize
+        || alignOffset(header->keysOffset) != header->keysOffset
+        || header->payloadOffset < 0 || alignOffset(header->payloadOffset) != header->payloadOffset
+        || header->payloadOffset > header->fileSize
+        || header->keysOffset + ((long long)header->count + 1) * (long long)sizeof(int) > header->payloadOffset
+        || header->payloadOffset + ((long long)header->count + 1) * (long long)sizeof(Medicine) > header->fileSize) {
+        munmap(base, st.st_size);
+        return 0;
+    }
+    snap->base = base;
+    snap->size = st.st_size;
+    snap->view.keys = (int*)((char*)base + header->keysOffset);
+    snap->view.payload = (Medicine*)((char*)base + header->payloadOffset);
+    snap->view.n = header->count;
+    return 1;
+}
+
+const Medicine* snapshot_find(const MappedSnapshot* snap, int id) {
+    int slot = eytz_search(&snap->view, id);
+    return slot ? &snap->view.payload[slot] : NULL;
+}
+
+void snapshot_close(MappedSnapshot* snap) {
+    if (snap->base != NULL)
+        munmap(snap->base, snap->size);
+    snap->base = NULL;
+}
+
+Node* snapshot_rebuild(const MappedSnapshot* snap) {
+    int n = snap->view.n;
+    if (n == 0)
+        return NULL;
+    MedicineRecord* items = (MedicineRecord*)malloc(n * sizeof(MedicineRecord));
+    if (items == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int k = 1, count = 0;
+    while (2 * k <= n)
+        k = 2 * k;
+    while (k != 0) {
+        items[count].medicineID = snap->view.keys[k];
+        items[count].data = snap->view.payload[k];
+        items[count].data.name[sizeof(items[count].data.name) - 1] = '\0';
+        count++;
+        if (2 * k + 1 <= n) {
+            k = 2 * k + 1;
+            while (2 * k <= n)
+                k = 2 * k;
+        } else {
+            while (k & 1)
+                k >>= 1;
+            k >>= 1;
+        }
+    }
+    Node* root = avl_bulkLoad(items, count);
+    free(items);
+    return root;
+}
+
+typedef struct RebuildJob {
+    const MappedSnapshot* snap;
+    Node* root;
+    double seconds;
+    int done;
+} RebuildJob;
+
+void* snapshotRebuildThread(void* arg) {
+    RebuildJob* job = (RebuildJob*)arg;
+    double start = nowSeconds();
+    job->root = snapshot_rebuild(job->snap);
+    job->seconds = nowSeconds() - start;
+    __atomic_store_n(&job->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+void displayMenu(Node* root) {
+    int choice;
+    while(1) {
+        printf("\n  -- Display Menu (Morris Traversal) --\n");
+        printf("  1. Inorder (Sorted by ID)\n");
+        printf("  2. Preorder\n");
+        printf("  3. Postorder\n");
+        printf("  4. Back\n");
+        choice = getInt();
+        
+        switch(choice) {
+            case 1:
+                printf("\n--- Morris Inorder Traversal ---\n");
+                morrisInorder(root);
+                break;
+            case 2:
+                printf("\n--- Morris Preorder Traversal ---\n");
+                morrisPreorder(root);
+                break;
+            case 3:
+                printf("\n--- Morris Postorder Traversal ---\n");
+                morrisPostorder(root);
+                break;
+            case 4:
+                return;
+            default:
+                printf("!! Invalid choice.\n");
+        }
+    }
+}
+
+void analyticsMenu(Node* root) {
+    int choice, a, b;
+    Node* found;
+    while(1) {
+        printf("\n  -- Inventory Analytics (Rank & Range Queries) --\n");
+        printf("  1. Count medicines with IDs in [a, b]\n");
+        printf("  2. Total stock value (Qty x Price) for IDs in [a, b]\n");
+        printf("  3. Find k-th smallest Medicine ID\n");
+        printf("  4. Rank of a Medicine ID\n");
+        printf("  5. Back\n");
+        choice = getInt();
+
+        switch(choice) {
+            case 1:
+                printf("  Enter lower ID (a): ");
+                a = getInt();
+                printf("  Enter upper ID (b): ");
+                b = getInt();
+                printf("== Result: %d medicine(s) with IDs in [%d, %d] ==\n", rangeCount(root, a, b), a, b);
+                break;
+            case 2:
+                printf("  Enter lower ID (a): ");
+                a = getInt();
+                printf("  Enter upper ID (b): ");
+                b = getInt();
+                printf("== Result: Stock value for IDs in [%d, %d] is $%.2f ==\n", a, b, rangeSum(root, a, b));
+                break;
+            case 3:
+                printf("  Enter k (1 = smallest, %d = largest): ", nodeSize(root));
+                a = getInt();
+                found = kthSmallest(root, a);
+                if (found == NULL) {
+                    printf("!! Error: k must be between 1 and %d.\n", nodeSize(root));
+                } else {
+                    printf("== Result: Position %d in ID order ==\n", a);
+                    printNode(found);
+                }
+                break;
+            case 4:
+                printf("  Enter Medicine ID: ");
+                a = getInt();
+                printf("== Result: %d medicine(s) have an ID smaller than %d ==\n", rank(root, a), a);
+                break;
+            case 5:
+                return;
+            default:
+                printf("!! Invalid choice.\n");
+        }
+    }
+}
+
+Node* runGuidedDemo(Node* root, int isAVL) {
+    printf("\n--- [Running Guided Demo] ---\n");
+    printf("Action: Clearing any existing data...\n");
+    freeTree(root);
+    root = NULL;
+    pressEnterToContinue();
+
+    printf("[SCENARIO 1: Initial Stocking]\n");
+    printf("Action: Inserting 5 medicines: (50, Paracetamol), (25, Ibuprofen), (75, Aspirin), (15, Amoxicillin), (30, Metformin)\n");
+    Medicine m1 = {"Paracetamol", 100, 5.50};
+    Medicine m2 = {"Ibuprofen", 50, 8.00};
+    Medicine m3 = {"Aspirin", 75, 3.25};
+    Medicine m4 = {"Amoxicillin", 120, 15.00};
+    Medicine m5 = {"Metformin", 60, 12.75};
+
+    if(isAVL) {
+        root = avl_insert(root, 50, m1);
+        root = avl_insert(root, 25, m2);
+        root = avl_insert(root, 75, m3);
+        root = avl_insert(root, 15, m4);
+        root = avl_insert(root, 30, m5); 
+    } else {
+        root = bst_insert(root, 50, m1);
+        root = bst_insert(root, 25, m2);
+        root = bst_insert(root, 75, m3);
+        root = bst_insert(root, 15, m4);
+        root = bst_insert(root, 30, m5);
+    }
+    printf("Current Inventory (Inorder):\n");
+    morrisInorder(root);
+    pressEnterToContinue();
+
+    printf("[SCENARIO 2: Searching Inventory]\n");
+    printf("Action: Searching for Medicine ID 30 (Metformin)...\n");
+    Node* found = search(root, 30);
+    if(found) { printf("Result: Found! "); printNode(found); }
+    else { printf("Result: Not Found.\n"); }
+
+    printf("\nAction: Searching for Medicine ID 99 (Non-existent)...\n");
+    found = search(root, 99);
+    if(found) { printf("Result: Found! "); printNode(found); }
+    else { printf("Result: Not Found.\n"); }
+    pressEnterToContinue();
+
+    printf("[SCENARIO 3: Deleting Items]\n");
+    printf("Action: Deleting Medicine ID 15 (Amoxicillin) - a leaf node.\n");
+    if(isAVL) { root = avl_delete(root, 15); }
+    else { root = bst_delete(root, 15); }
+    printf("Current Inventory (Inorder):\n");
+    morrisInorder(root);
+    pressEnterToContinue();
+
+    printf("Action: Deleting Medicine ID 75 (Aspirin) - a leaf node.\n");
+    if(isAVL) { root = avl_delete(root, 75); }
+    else { root = bst_delete(root, 75); }
+    printf("Current Inventory (Inorder):\n");
+    morrisInorder(root);
+    pressEnterToContinue();
+
+    printf("Action: Deleting Medicine ID 50 (Paracetamol) - the root node with two children.\n");
+    if(isAVL) { root = avl_delete(root, 50); } 
+    else { root = bst_delete(root, 50); }
+    printf("Current Inventory (Inorder):\n");
+    morrisInorder(root);
+    
+    printf("\n--- [Demo Complete] ---\n");
+    return root;
+}
+
+Node* loadSkewedData(Node* root, int isAVL) {
+    printf("\n--- [Loading Skewed Data Demo] ---\n");
+    printf("Action: Clearing any existing data...\n");
+    freeTree(root);
+    root = NULL;
+
+    printf("Action: Inserting IDs 10, 20, 30, 40, 50 in ascending order.\n");
+    int ids[] = {10, 20, 30, 40, 50};
+    char names[][100] = {"Med-A", "Med-B", "Med-C", "Med-D", "Med-E"};
+    
+    for(int i=0; i<5; i++) {
+        Medicine m = {"", 0, 0.0};
+        strcpy(m.name, names[i]);
+        m.quantity = 10 * (i+1);
+        m.price = 5.0 * (i+1);
+        
+        if(isAVL) {
+            root = avl_insert(root, ids[i], m);
+        } else {
+            root = bst_insert(root, ids[i], m);
+        }
+    }
+    
+    printf("-> Skewed data loaded.\n");
+    if(isAVL) {
+        printf("Notice: The AVL tree rebalanced itself during insertions.\n");
+    } else {
+        printf("Notice: The BST is now a degenerate tree (a linked list).\n");
+    }
+    printf("Use 'Display Inventory' (Preorder) to see the resulting structure.\n");
+    return root;
+}
+
+// Returns NULL (after a message) when the last ID would not fit in an int
+MedicineRecord* generateCatalog(int n, int startID, int step) {
+    long long lastID = (long long)startID + (long long)(n - 1) * step;
+    if (lastID > INT_MAX || lastID < INT_MIN) {
+        printf("!! Catalog IDs would run past the Medicine ID range (last ID %lld).\n", lastID);
+        return NULL;
+    }
+    MedicineRecord* items = (MedicineRecord*)malloc(n * sizeof(MedicineRecord));
+    if (items == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) {
+        items[i].medicineID = (int)((long long)startID + (long long)i * step);
+        snprintf(items[i].data.name, sizeof(items[i].data.name), "Med-%d", items[i].medicineID);
+        items[i].data.quantity = 10 + i % 90;
+        items[i].data.price = 1.0f + (i % 50) * 0.5f;
+    }
+    return items;
+}
+
+Node* bulkImportMenu(Node* root) {
+    printf("\n  -- Bulk Import Catalog --\n");
+    printf("  1. Replace inventory with a sorted catalog (O(n) build)\n");
+    printf("  2. Merge a sorted batch into the current inventory (existing IDs are updated)\n");
+    printf("  3. Back\n");
+    int mode = getInt();
+    if (mode != 1 && mode != 2)
+        return root;
+
+    printf("  Number of medicines to import: ");
+    int n = getInt();
+    if (n <= 0) {
+        printf("!! Count must be positive.\n");
+        return root;
+    }
+    printf("  Starting Medicine ID: ");
+    int startID = getInt();
+    printf("  ID step between items: ");
+    int step = getInt();
+    if (step <= 0) {
+        printf("!! Step must be positive.\n");
+        return root;
+    }
+
+    MedicineRecord* items = generateCatalog(n, startID, step);
+    if (items == NULL)
+        return root;
+    int before = nodeSize(root);
+    double start = nowSeconds();
+    if (mode == 1) {
+        freeTree(root);
+        root = avl_bulkLoad(items, n);
+    } else {
+        root = avl_bulkMerge(root, items, n);
+    }
+    double elapsed = nowSeconds() - start;
+    free(items);
+
+    printf("-> %s %d medicines in %.3f ms.\n", mode == 1 ? "Built" : "Merged", n, elapsed * 1000.0);
+    if (mode == 2) {
+        // Unlike Insert Medicine, which keeps the existing record, a merge overwrites it
+        int added = nodeSize(root) - before;
+        printf("-> %d new IDs added, %d existing IDs overwritten with the catalog data.\n", added, n - added);
+    }
+    printf("-> Inventory now holds %d medicines, tree height %d.\n", nodeSize(root), height(root));
+    return root;
+}
+
+#define MAX_NAME_MATCHES 50
+
+void nameSearchMenu(Node* root, NameIndex* names) {
+    char key[100];
+    int ids[MAX_NAME_MATCHES];
+    printf("\n  -- Search by Medicine Name --\n");
+    printf("  1. Exact name\n");
+    printf("  2. Name prefix (e.g. 'Amoxi')\n");
+    printf("  3. Back\n");
+    int mode = getInt();
+    if (mode != 1 && mode != 2)
+        return;
+
+    printf("  Enter %s: ", mode == 1 ? "name" : "prefix");
+    if (fgets(key, sizeof(key), stdin) == NULL)
+        return;
+    key[strcspn(key, "\n")] = 0;
+
+    int count = 0;
+    if (mode == 1) {
+        for (NameEntry* e = nameIndex_exact(names, key); e != NULL && count < MAX_NAME_MATCHES; e = e->next)
+            ids[count++] = e->medicineID;
+    } else {
+        count = nameIndex_prefix(names, key, ids, MAX_NAME_MATCHES);
+    }
+
+    if (count == 0) {
+        printf("!! Result: No medicine matches '%s'.\n", key);
+        return;
+    }
+    printf("== Result: %d match(es)%s ==\n", count, count == MAX_NAME_MATCHES ? " (list truncated)" : "");
+    for (int i = 0; i < count; i++)
+        printNode(search(root, ids[i]));
+}
+
+void saveSnapshotMenu(Node* root) {
+    char path[256];
+    printf("  Snapshot file path: ");
+    if (fgets(path, sizeof(path), stdin) == NULL)
+        return;
+    path[strcspn(path, "\n")] = 0;
+    double start = nowSeconds();
+    if (!snapshot_save(root, path)) {
+        printf("!! Error: Could not write snapshot '%s'.\n", path);
+        return;
+    }
+    printf("-> Saved %d medicines to '%s' in %.3f ms.\n", nodeSize(root), path, (nowSeconds() - start) * 1000.0);
+}
+
+Node* loadSnapshotMenu(Node* root) {
+    char path[256];
+    printf("  Snapshot file path: ");
+    if (fgets(path, sizeof(path), stdin) == NULL)
+        return root;
+    path[strcspn(path, "\n")] = 0;
+
+    MappedSnapshot snap;
+    double start = nowSeconds();
+    if (!snapshot_open(path, &snap)) {
+        printf("!! Error: '%s' is missing or not a valid inventory snapshot.\n", path);
+        return root;
+    }
+    printf("-> Mapped %d medicines in %.3f ms (searchable in place).\n",
+           snap.view.n, (nowSeconds() - start) * 1000.0);
+
+    RebuildJob job = {&snap, NULL, 0.0, 0};
+    pthread_t tid;
+    pthread_create(&tid, NULL, snapshotRebuildThread, &job);
+
+    printf("  The mutable tree is rebuilding in the background; lookups are served meanwhile.\n");
+    while (1) {
+        printf("  Enter Medicine ID to search (-1 to finish): ");
+        int id = getInt();
+        if (id == -1)
+            break;
+        if (__atomic_load_n(&job.done, __ATOMIC_ACQUIRE)) {
+            Node* found = search(job.root, id);
+            if (found == NULL) {
+                printf("!! Result: Medicine ID %d not found.\n", id);
+            } else {
+                printf("== Result: Medicine Found (rebuilt tree) ==\n");
+                printNode(found);
+            }
+            continue;
+        }
+        const Medicine* m = snapshot_find(&snap, id);
+        if (m == NULL) {
+            printf("!! Result: Medicine ID %d not found.\n", id);
+        } else {
+            printf("== Result: Medicine Found (mapped snapshot) ==\n");
+            // Names come straight from the file, so never read past name[]
+            printf("[ID: %-5d | Name: %-20.*s | Qty: %-5d | Price: $%.2f]\n",
+                   id, (int)sizeof(m->name), m->name, m->quantity, m->price);
+        }
+    }
+    pthread_join(tid, NULL);
+
+    freeTree(root);
+    printf("-> Rebuilt the mutable tree in %.3f ms (height %d).\n", job.seconds * 1000.0, height(job.root));
+    snapshot_close(&snap);
+    return job.root;
+}
+
+void handleTree(Node** root, NameIndex* names, int isAVL) {
+    int choice, id;
+    Node* found;
+    Medicine data;
+    char treeType[4];
+    strcpy(treeType, isAVL ? "AVL" : "BST");
+
+    while (1) {
+        printf("\n--- Pharmacy Management (%s Tree) ---\n", treeType);
+        printf("1. Insert Medicine\n");
+        printf("2. Delete Medicine\n");
+        printf("3. Search Medicine\n");
+        printf("4. Display Inventory\n");
+        printf("5. Run Guided Demo\n");
+        printf("6. Load Skewed Data (for Demo)\n");
+        printf("7. Inventory Analytics (Rank & Range Queries)\n");
+        printf("8. Bulk Import Catalog\n");
+        printf("9. Search by Name (Exact / Prefix)\n");
+        printf("10. Save Inventory Snapshot\n");
+        printf("11. Load Inventory Snapshot\n");
+        printf("12. Back to Main Menu\n");
+
+        choice = getInt();
+
+        switch (choice) {
+            case 1:
+                printf("  Enter Medicine ID (Key): ");
+                id = getInt();
+                found = search(*root, id);
+                if (found != NULL) {
                     printf("!! Error: Medicine ID %d already exists.\n", id);
                     continue;
                 }
@@ -529,10 +3376,7 @@ void handleTree(Node** root, int isAVL) {
                     data.price = 0.0;
                 }
                 clearInputBuffer();
-                if (isAVL)
-                    *root = avl_insert(*root, id, data);
-                else
-                    *root = bst_insert(*root, id, data);
+                *root = inventoryInsert(*root, names, id, data, isAVL);
                 printf("-> Medicine ID %d inserted.\n", id);
                 break;
 
@@ -543,10 +3387,7 @@ void handleTree(Node** root, int isAVL) {
                 if (found == NULL) {
                     printf("!! Error: Medicine ID %d not found.\n", id);
                 } else {
-                    if (isAVL)
-                        *root = avl_delete(*root, id);
-                    else
-                        *root = bst_delete(*root, id);
+                    *root = inventoryDelete(*root, names, id, isAVL);
                     printf("-> Medicine ID %d deleted.\n", id);
                 }
                 break;
@@ -569,82 +3410,964 @@ void handleTree(Node** root, int isAVL) {
                 
             case 5:
                 *root = runGuidedDemo(*root, isAVL);
+                nameIndex_rebuild(names, *root);
                 break;
 
             case 6:
                 *root = loadSkewedData(*root, isAVL);
+                nameIndex_rebuild(names, *root);
                 break;
 
             case 7:
+                analyticsMenu(*root);
+                break;
+
+            case 8:
+                *root = bulkImportMenu(*root);
+                nameIndex_rebuild(names, *root);
+                break;
+
+            case 9:
+                nameSearchMenu(*root, names);
+                break;
+
+            case 10:
+                saveSnapshotMenu(*root);
+                break;
+
+            case 11:
+                *root = loadSnapshotMenu(*root);
+                nameIndex_rebuild(names, *root);
+                break;
+
+            case 12:
                 return;
 
             default:
                 printf("!! Invalid choice. Please try again.\n");
         }
         
-        if (choice != 4 && choice != 7) {
+        if (choice != 4 && choice != 7 && choice != 12) {
              pressEnterToContinue();
         }
     }
 }
 
-void compareComplexities() {
-    printf("\n--- Time Complexity Analysis: BST vs. AVL ---\n\n");
-    printf("N = Number of nodes in the tree. H = Height of the tree.\n\n");
-    printf("=======================================================================\n");
-    printf("| Operation |   Data Structure   |   Average Case   |    Worst Case    |\n");
-    printf("=======================================================================\n");
-    printf("| Search    | Binary Search Tree | O(log N)         | O(N)             |\n");
-    printf("|           | AVL Tree           | O(log N)         | O(log N)         |\n");
-    printf("-----------------------------------------------------------------------\n");
-    printf("| Insertion | Binary Search Tree | O(log N)         | O(N)             |\n");
-    printf("|           | AVL Tree           | O(log N)         | O(log N)         |\n");
-    printf("-----------------------------------------------------------------------\n");
-    printf("| Deletion  | Binary Search Tree | O(log N)         | O(N)             |\n");
-    printf("|           | AVL Tree           | O(log N)         | O(log N)         |\n");
-    printf("=======================================================================\n\n");
-    
-    printf("Key Takeaway:\n");
-    printf(" * **BST (Worst Case):** When data is inserted in sorted order (like in the\n");
-    printf("   'Load Skewed Data' demo), the BST degenerates into a linked list.\n");
-    printf("   The height (H) becomes N, so operations become O(N), which is slow.\n\n");
-    
-    printf(" * **AVL (Worst Case):** The AVL tree performs rotations (like `leftRotate`,\n");
-    printf("   `rightRotate`) during insertion and deletion to *guarantee* the tree\n");
-    printf("   remains balanced. The height (H) is always kept at O(log N).\n");
-    printf("   This ensures that all operations are *always* O(log N).\n");
-    
-    pressEnterToContinue();
+typedef struct SnapshotReaderArgs {
+    PersistentInventory* inv;
+    int keySpace;
+    volatile int* stop;
+    long reads;
+    long lookupsFound;
+    long inconsistent;
+    long minVersion;
+    long maxVersion;
+} SnapshotReaderArgs;
+
+void* snapshotReader(void* arg) {
+    SnapshotReaderArgs* args = (SnapshotReaderArgs*)arg;
+    int slot = pavl_registerReader(args->inv);
+    if (slot < 0) {
+        printf("!! Error: Too many snapshot readers (max %d).\n", MAX_READERS);
+        return NULL;
+    }
+    unsigned int seed = 0x9E3779B9u ^ (unsigned int)slot;
+    args->minVersion = -1;
+    while (!__atomic_load_n(args->stop, __ATOMIC_ACQUIRE)) {
+        Snapshot snap = pavl_readBegin(args->inv, slot);
+        double value;
+        int count = snapshotWalk(snap.root, &value);
+        double expected = nodeSum(snap.root);
+        if (count != nodeSize(snap.root) || value - expected > 1e-6 * (expected + 1.0) || expected - value > 1e-6 * (expected + 1.0))
+            args->inconsistent++;
+        if (search(snap.root, (int)(nextRandom(&seed) % args->keySpace)) != NULL)
+            args->lookupsFound++;
+        pavl_readEnd(args->inv, slot);
+
+        if (args->minVersion < 0)
+            args->minVersion = snap.version;
+        args->maxVersion = snap.version;
+        args->reads++;
+    }
+    pavl_unregisterReader(args->inv, slot);
+    return NULL;
+}
+
+void concurrentSnapshotDemo() {
+    printf("\n--- Concurrent Reporting Demo (Persistent AVL) ---\n");
+    printf("  Number of reporting (reader) threads (1-%d): ", MAX_READERS);
+    int readers = getInt();
+    if (readers < 1 || readers > MAX_READERS) {
+        printf("!! Reader count must be between 1 and %d.\n", MAX_READERS);
+        return;
+    }
+    printf("  Initial inventory size: ");
+    int n = getInt();
+    if (n <= 0) {
+        printf("!! Size must be positive.\n");
+        return;
+    }
+    printf("  Number of counter updates (inserts/deletes): ");
+    int updates = getInt();
+    if (updates < 0) {
+        printf("!! Update count cannot be negative.\n");
+        return;
+    }
+
+    MedicineRecord* items = generateCatalog(n, 0, 2);
+    if (items == NULL)
+        return;
+    PersistentInventory inv;
+    pavl_init(&inv);
+    int keySpace = 2 * n;
+    pavl_publish(&inv, avl_bulkLoad(items, n));
+    free(items);
+
+    volatile int stop = 0;
+    pthread_t* threads = (pthread_t*)malloc(readers * sizeof(pthread_t));
+    SnapshotReaderArgs* args = (SnapshotReaderArgs*)calloc(readers, sizeof(SnapshotReaderArgs));
+    for (int i = 0; i < readers; i++) {
+        args[i].inv = &inv;
+        args[i].keySpace = keySpace;
+        args[i].stop = &stop;
+        pthread_create(&threads[i], NULL, snapshotReader, &args[i]);
+    }
+
+    unsigned int seed = 12345;
+    int applied = 0;
+    double start = nowSeconds();
+    for (int i = 0; i < updates; i++) {
+        int id = (int)(nextRandom(&seed) % keySpace);
+        Medicine m = {"", (int)(nextRandom(&seed) % 100), 2.5f};
+        snprintf(m.name, sizeof(m.name), "Med-%d", id);
+        if (nextRandom(&seed) & 1)
+            applied += pavl_insertMedicine(&inv, id, m);
+        else
+            applied += pavl_deleteMedicine(&inv, id);
+    }
+    double elapsed = nowSeconds() - start;
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    long reads = 0, inconsistent = 0;
+    for (int i = 0; i < readers; i++) {
+        pthread_join(threads[i], NULL);
+        reads += args[i].reads;
+        inconsistent += args[i].inconsistent;
+        printf("  Reader %2d: %ld snapshots (versions %ld..%ld)\n", i, args[i].reads, args[i].minVersion, args[i].maxVersion);
+    }
+
+    long waiting = inv.limbo[0].count + inv.limbo[1].count + inv.limbo[2].count;
+    printf("-> Writer applied %d of %d updates in %.3f ms (%.0f updates/sec).\n",
+           applied, updates, elapsed * 1000.0, elapsed > 0 ? updates / elapsed : 0.0);
+    printf("-> Published versions: %ld | Final inventory size: %d\n", inv.current->version, nodeSize(inv.current->root));
+    printf("-> Snapshot reads: %ld | Inconsistent snapshots: %ld\n", reads, inconsistent);
+    printf("-> Nodes and versions reclaimed by epochs: %ld | Awaiting reclamation: %ld\n", inv.reclaimed, waiting);
+
+    free(threads);
+    free(args);
+    pavl_destroy(&inv);
+}
+
+void eytzingerBenchmark() {
+    printf("\n--- Static Eytzinger Index vs. Pointer-Chasing Search ---\n");
+    printf("  Number of medicines in the tree: ");
+    int n = getInt();
+    printf("  Number of lookups to time: ");
+    int lookups = getInt();
+    if (n <= 0 || lookups <= 0) {
+        printf("!! Counts must be positive.\n");
+        return;
+    }
+
+    MedicineRecord* items = generateCatalog(n, 1, 3);
+    if (items == NULL)
+        return;
+    Node* root = avl_bulkLoad(items, n);
+    free(items);
+
+    double start = nowSeconds();
+    EytzingerIndex* index = eytz_build(root);
+    double buildTime = nowSeconds() - start;
+
+    int* queries = (int*)malloc(lookups * sizeof(int));
+    unsigned int seed = 2024;
+    for (int i = 0; i < lookups; i++)
+        queries[i] = 1 + (int)(nextRandom(&seed) % (unsigned int)(3 * n));
+
+    long hitsTree = 0, hitsIndex = 0;
+    start = nowSeconds();
+    for (int i = 0; i < lookups; i++)
+        if (search(root, queries[i]) != NULL)
+            hitsTree++;
+    double treeTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (int i = 0; i < lookups; i++)
+        if (eytz_search(index, queries[i]) != 0)
+            hitsIndex++;
+    double indexTime = nowSeconds() - start;
+
+    printf("-> Index rebuilt from the tree in %.3f ms.\n", buildTime * 1000.0);
+    printf("-> AVL search      : %8.1f ns/lookup (%ld hits)\n", treeTime * 1e9 / lookups, hitsTree);
+    printf("-> Eytzinger search: %8.1f ns/lookup (%ld hits)\n", indexTime * 1e9 / lookups, hitsIndex);
+    if (indexTime > 0)
+        printf("-> Speedup: %.2fx\n", treeTime / indexTime);
+
+    free(queries);
+    eytz_free(index);
+    freeTree(root);
+}
+
+void batchLookupBenchmark() {
+    printf("\n--- Batched (Prefetch-Interleaved) Lookups vs. Scalar Search ---\n");
+    printf("  Number of medicines in the tree: ");
+    int n = getInt();
+    printf("  Lookups per POS batch: ");
+    int batch = getInt();
+    printf("  Number of batches: ");
+    int batches = getInt();
+    if (n <= 0 || batch <= 0 || batches <= 0) {
+        printf("!! Counts must be positive.\n");
+        return;
+    }
+
+    MedicineRecord* items = generateCatalog(n, 1, 2);
+    if (items == NULL)
+        return;
+    unsigned int seed = 7;
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(nextRandom(&seed) % (unsigned int)(i + 1));
+        MedicineRecord t = items[i];
+        items[i] = items[j];
+        items[j] = t;
+    }
+    Node* root = NULL;
+    for (int i = 0; i < n; i++)
+        root = avl_insert(root, items[i].medicineID, items[i].data);
+    free(items);
+
+    int* ids = (int*)malloc(batch * sizeof(int));
+    Node** out = (Node**)malloc(batch * sizeof(Node*));
+    long hitsScalar = 0, hitsBatch = 0;
+    double scalarTime = 0.0, batchTime = 0.0;
+
+    for (int b = 0; b < batches; b++) {
+        for (int i = 0; i < batch; i++)
+            ids[i] = 1 + (int)(nextRandom(&seed) % (unsigned int)(2 * n));
+
+        double start = nowSeconds();
+        for (int i = 0; i < batch; i++)
+            if (search(root, ids[i]) != NULL)
+                hitsScalar++;
+        scalarTime += nowSeconds() - start;
+
+        start = nowSeconds();
+        searchBatch(root, ids, batch, out);
+        for (int i = 0; i < batch; i++)
+            if (out[i] != NULL)
+                hitsBatch++;
+        batchTime += nowSeconds() - start;
+    }
+
+    double total = (double)batch * batches;
+    printf("-> Tree: %d medicines (randomly inserted), height %d, ~%.1f MB of nodes.\n",
+           n, height(root), (double)n * sizeof(Node) / (1024.0 * 1024.0));
+    printf("-> Scalar search loop: %8.1f ns/lookup, %10.0f lookups/sec (%ld hits)\n",
+           scalarTime * 1e9 / total, total / scalarTime, hitsScalar);
+    printf("-> searchBatch       : %8.1f ns/lookup, %10.0f lookups/sec (%ld hits)\n",
+           batchTime * 1e9 / total, total / batchTime, hitsBatch);
+    if (batchTime > 0)
+        printf("-> Speedup: %.2fx\n", scalarTime / batchTime);
+
+    free(ids);
+    free(out);
+    freeTree(root);
+}
+
+#define PATTERN_RANDOM 0
+#define PATTERN_SEQUENTIAL 1
+#define PATTERN_CLUSTERED 2
+#define PATTERN_REVERSE 3
+#define PATTERN_ZIPF 4
+#define BST_DEGENERATE_LIMIT 20000
+#define ZIPF_THETA 0.99
+
+const char* patternNames[] = {"Random", "Sequential", "Clustered", "Reverse-sorted", "Zipf-skewed"};
+
+void shuffleKeys(int* keys, int n, unsigned int seed) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(nextRandom(&seed) % (unsigned int)(i + 1));
+        int t = keys[i];
+        keys[i] = keys[j];
+        keys[j] = t;
+    }
+}
+
+int* generateWorkloadKeys(int pattern, int n, unsigned int seed) {
+    int* keys = (int*)malloc(n * sizeof(int));
+    if (keys == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int base = 0;
+    double zetan = 0.0, eta = 0.0, alpha = 1.0 / (1.0 - ZIPF_THETA);
+    if (pattern == PATTERN_ZIPF) {
+        for (int i = 1; i <= n; i++)
+            zetan += 1.0 / pow((double)i, ZIPF_THETA);
+        double zeta2 = 1.0 + pow(0.5, ZIPF_THETA);
+        eta = (1.0 - pow(2.0 / n, 1.0 - ZIPF_THETA)) / (1.0 - zeta2 / zetan);
+    }
+    for (int i = 0; i < n; i++) {
+        if (pattern == PATTERN_SEQUENTIAL) {
+            keys[i] = i + 1;
+        } else if (pattern == PATTERN_REVERSE) {
+            keys[i] = n - i;
+        } else if (pattern == PATTERN_ZIPF) {
+            double u = nextRandom(&seed) / 4294967296.0;
+            double uz = u * zetan;
+            unsigned int rank;
+            if (uz < 1.0)
+                rank = 1;
+            else if (uz < 1.0 + pow(0.5, ZIPF_THETA))
+                rank = 2;
+            else
+                rank = 1 + (unsigned int)(n * pow(eta * u - eta + 1.0, alpha));
+            keys[i] = (int)((rank * 2654435761u) & 0x7FFFFFFF);
+        } else if (pattern == PATTERN_CLUSTERED) {
+            if (i % 1000 == 0)
+                base = (int)(nextRandom(&seed) & 0x3FFFFFFF);
+            keys[i] = base + i % 1000;
+        } else {
+            keys[i] = (int)(nextRandom(&seed) & 0x7FFFFFFF);
+        }
+    }
+    if (pattern == PATTERN_CLUSTERED)
+        shuffleKeys(keys, n, seed);
+    return keys;
+}
+
+typedef struct OrderCheck {
+    int last;
+    int count;
+    int ordered;
+} OrderCheck;
+
+void checkOrderVisit(int id, Medicine* data, void* ctx) {
+    (void)data;
+    OrderCheck* check = (OrderCheck*)ctx;
+    if (check->count > 0 && id <= check->last)
+        check->ordered = 0;
+    check->last = id;
+    check->count++;
+}
+
+void engineWorkloadRow(InventoryEngine* engine, int* keys, int* probes, int n) {
+    Medicine m = {"Bench", 10, 1.0f};
+    void* store = engine->create();
+    int stored = 0;
+
+    double start = nowSeconds();
+    for (int i = 0; i < n; i++)
+        stored += engine->insert(store, keys[i], m);
+    double insertTime = nowSeconds() - start;
+
+    long hits = 0;
+    start = nowSeconds();
+    for (int i = 0; i < n; i++)
+        if (engine->find(store, probes[i]) != NULL)
+            hits++;
+    double searchTime = nowSeconds() - start;
+
+    OrderCheck check = {0, 0, 1};
+    start = nowSeconds();
+    engine->forEach(store, checkOrderVisit, &check);
+    double iterateTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (int i = 0; i < n / 2; i++)
+        engine->remove(store, probes[i]);
+    double deleteTime = nowSeconds() - start;
+
+    printf("| %-4s | %10.1f | %10.1f | %10.1f | %10.1f | %-9s |\n", engine->name,
+           insertTime * 1e9 / n, searchTime * 1e9 / n, iterateTime * 1e9 / (stored ? stored : 1),
+           deleteTime * 1e9 / (n / 2 ? n / 2 : 1),
+           (check.ordered && check.count == stored && hits == n) ? "OK" : "MISMATCH");
+    engine->destroy(store);
+}
+
+void artBenchmark() {
+    printf("\n--- ART vs. BST vs. AVL (ns per operation) ---\n");
+    printf("  Number of medicine IDs per workload: ");
+    int n = getInt();
+    if (n <= 0) {
+        printf("!! Count must be positive.\n");
+        return;
+    }
+    InventoryEngine* engines[] = {&bstEngine, &avlEngine, &artEngine};
+
+    for (int pattern = PATTERN_RANDOM; pattern <= PATTERN_CLUSTERED; pattern++) {
+        int* keys = generateWorkloadKeys(pattern, n, 99u + pattern);
+        int* probes = (int*)malloc(n * sizeof(int));
+        memcpy(probes, keys, n * sizeof(int));
+        shuffleKeys(probes, n, 7u + pattern);
+
+        printf("\nWorkload: %s IDs (n = %d)\n", patternNames[pattern], n);
+        printf("+------+------------+------------+------------+------------+-----------+\n");
+        printf("| Eng. |   Insert   |   Search   |  Iterate   |   Delete   |   Check   |\n");
+        printf("+------+------------+------------+------------+------------+-----------+\n");
+        for (int e = 0; e < 3; e++) {
+            if (engines[e] == &bstEngine && pattern == PATTERN_SEQUENTIAL && n > BST_DEGENERATE_LIMIT) {
+                printf("| %-4s | skipped: degenerate O(n^2) chain above %d IDs            |\n",
+                       engines[e]->name, BST_DEGENERATE_LIMIT);
+                continue;
+            }
+            engineWorkloadRow(engines[e], keys, probes, n);
+        }
+        printf("+------+------------+------------+------------+------------+-----------+\n");
+        free(keys);
+        free(probes);
+    }
+}
+
+Node* buildRandomInventory(int* ids, int n) {
+    MedicineRecord* items = (MedicineRecord*)malloc(n * sizeof(MedicineRecord));
+    if (items == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) {
+        items[i].medicineID = ids[i];
+        snprintf(items[i].data.name, sizeof(items[i].data.name), "Med-%d", ids[i]);
+        items[i].data.quantity = 1 + i % 50;
+        items[i].data.price = 2.0f;
+    }
+    Node* root = avl_bulkLoad(items, n);
+    free(items);
+    return root;
+}
+
+Node* naiveSetOperation(int op, Node* hq, Node* hqCopy, Node** items, int nb) {
+    Node* result = NULL;
+    if (op == SET_UNION) {
+        result = hqCopy;
+        for (int i = 0; i < nb; i++)
+            if (!adjustStock(result, items[i]->medicineID, items[i]->data.quantity))
+                result = avl_insert(result, items[i]->medicineID, items[i]->data);
+    } else if (op == SET_INTERSECTION) {
+        freeTree(hqCopy);
+        for (int i = 0; i < nb; i++) {
+            Node* found = search(hq, items[i]->medicineID);
+            if (found != NULL)
+                result = avl_insert(result, found->medicineID, found->data);
+        }
+    } else {
+        result = hqCopy;
+        for (int i = 0; i < nb; i++)
+            if (search(result, items[i]->medicineID) != NULL)
+                result = avl_delete(result, items[i]->medicineID);
+    }
+    return result;
+}
+
+double setOperationsTable(int n, int m, int overlap, int threads, ThreadPool* pool) {
+    int* hqIds = (int*)malloc(n * sizeof(int));
+    int* branchIds = (int*)malloc(m * sizeof(int));
+    unsigned int seed = 31337;
+    for (int i = 0; i < n; i++)
+        hqIds[i] = 2 * i;
+    for (int i = 0; i < m; i++) {
+        if ((int)(nextRandom(&seed) % 100) < overlap)
+            branchIds[i] = 2 * (int)(nextRandom(&seed) % (unsigned int)n);
+        else
+            branchIds[i] = 2 * (int)(nextRandom(&seed) % (unsigned int)(n + m)) + 1;
+    }
+    Node* hq = buildRandomInventory(hqIds, n);
+    Node* branch = buildRandomInventory(branchIds, m);
+    free(hqIds);
+    free(branchIds);
+
+    const char* opNames[] = {"Union", "Intersection", "Difference"};
+    printf("\nHQ: %d items | Branch: %d distinct items\n", nodeSize(hq), nodeSize(branch));
+    printf("+--------------+------------+-----------------+---------------+---------+-------+\n");
+    printf("| Operation    | Naive (ms) | Join, 1 th (ms) | Join, %2d th   | Speedup | Check |\n", threads);
+    printf("+--------------+------------+-----------------+---------------+---------+-------+\n");
+    Node** branchItems = (Node**)malloc(nodeSize(branch) * sizeof(Node*));
+    int nb = flattenInorder(branch, branchItems);
+    double freeTime = 0.0;
+    for (int op = SET_UNION; op <= SET_DIFFERENCE; op++) {
+        Node* hqCopy = op == SET_INTERSECTION ? NULL : copyTree(hq);
+        double start = nowSeconds();
+        Node* naive = naiveSetOperation(op, hq, hqCopy, branchItems, nb);
+        double naiveTime = nowSeconds() - start;
+
+        RetireList dropped;
+        memset(&dropped, 0, sizeof(RetireList));
+        Node* a = copyTree(hq);
+        Node* b = copyTree(branch);
+        start = nowSeconds();
+        Node* sequential = setOperation(op, a, b, NULL, &dropped);
+        double seqTime = nowSeconds() - start;
+        start = nowSeconds();
+        freeDropped(&dropped);
+        freeTime += nowSeconds() - start;
+
+        a = copyTree(hq);
+        b = copyTree(branch);
+        start = nowSeconds();
+        Node* parallel = setOperation(op, a, b, threads > 1 ? pool : NULL, &dropped);
+        double parTime = nowSeconds() - start;
+        start = nowSeconds();
+        freeDropped(&dropped);
+        freeTime += nowSeconds() - start;
+
+        double expected = nodeSum(naive);
+        double diff = nodeSum(parallel) - expected;
+        int ok = nodeSize(naive) == nodeSize(sequential) && nodeSize(naive) == nodeSize(parallel)
+                 && diff * diff <= 1e-12 * (expected * expected + 1.0);
+        printf("| %-12s | %10.2f | %15.2f | %13.2f | %6.2fx | %-5s |\n", opNames[op],
+               naiveTime * 1000.0, seqTime * 1000.0, parTime * 1000.0,
+               parTime > 0 ? naiveTime / parTime : 0.0, ok ? "OK" : "FAIL");
+        freeTree(naive);
+        freeTree(sequential);
+        freeTree(parallel);
+    }
+    printf("+--------------+------------+-----------------+---------------+---------+-------+\n");
+    free(branchItems);
+    freeTree(hq);
+    freeTree(branch);
+    return freeTime;
+}
+
+void setOperationsBenchmark() {
+    printf("\n--- Branch/HQ Inventory Set Operations (Join-Based) ---\n");
+    printf("  HQ inventory size: ");
+    int n = getInt();
+    printf("  Branch inventory size: ");
+    int m = getInt();
+    printf("  Percent of branch items also stocked at HQ (0-100): ");
+    int overlap = getInt();
+    printf("  Worker threads for the parallel run: ");
+    int threads = getInt();
+    if (n <= 0 || m <= 0 || overlap < 0 || overlap > 100 || threads <= 0) {
+        printf("!! Invalid sizes, overlap or thread count.\n");
+        return;
+    }
+
+    ThreadPool* pool = pool_create(threads - 1 > 0 ? threads - 1 : 1);
+    double freeTime = setOperationsTable(n, m, overlap, threads, pool);
+    if (m > n / 100 && n >= 1000) {
+        // Joins do O(m log(n/m+1)) work against m log n for the naive loop, so
+        // the gap shows when a small branch is merged into a large HQ
+        printf("\nSkewed case: branch is HQ / 1000.\n");
+        freeTime += setOperationsTable(n, n / 1000, overlap, threads, pool);
+    }
+    printf("Speedup is naive per-item avl_insert/search time over the parallel join run.\n");
+    printf("Join runs reuse their input nodes and hand dropped subtrees back to the caller;\n");
+    printf("releasing those afterwards took %.2f ms in total and is not part of the join times.\n",
+           freeTime * 1000.0);
+    pool_destroy(pool);
+}
+
+typedef struct MixResult {
+    double insertNs;
+    double mixNs;
+    double deleteNs;
+    long rotations;
+    int height;
+    double bytesPerItem;
+    int items;
+} MixResult;
+
+MixResult runEngineMix(InventoryEngine* engine, int* keys, int* extra, int n, unsigned int seed) {
+    MixResult r;
+    Medicine m = {"Bench", 10, 1.0f};
+    void* store = engine->create();
+    long rotationsBefore = treeStats_snapshot().rotations;
+
+    double start = nowSeconds();
+    for (int i = 0; i < n; i++)
+        engine->insert(store, keys[i], m);
+    r.insertNs = (nowSeconds() - start) * 1e9 / n;
+    r.height = engine->height(store);
+
+    int mixOps = n, nextExtra = 0;
+    long hits = 0;
+    start = nowSeconds();
+    for (int i = 0; i < mixOps; i++) {
+        unsigned int roll = nextRandom(&seed);
+        int key = keys[(roll >> 8) % (unsigned int)n];
+        if (roll % 100 < 80) {
+            if (engine->find(store, key) != NULL)
+                hits++;
+        } else if (roll % 100 < 90) {
+            engine->insert(store, extra[nextExtra++ % n], m);
+        } else {
+            engine->remove(store, key);
+        }
+    }
+    r.mixNs = (nowSeconds() - start) * 1e9 / mixOps;
+
+    OrderCheck count = {0, 0, 1};
+    engine->forEach(store, checkOrderVisit, &count);
+    r.items = count.count;
+    r.bytesPerItem = count.count ? (double)engine->memoryBytes(store) / count.count : 0.0;
+
+    start = nowSeconds();
+    for (int i = 0; i < n; i++)
+        engine->remove(store, keys[i]);
+    r.deleteNs = (nowSeconds() - start) * 1e9 / n;
+    r.rotations = treeStats_snapshot().rotations - rotationsBefore;
+
+    engine->destroy(store);
+    return r;
+}
+
+void benchmarkEngines() {
+    printf("\n--- Measured Engine Benchmark: BST vs AVL vs Treap vs Skip List vs ART ---\n");
+    printf("Sizes run from 10^3 up to 10^k. Each run inserts n IDs, performs n mixed\n");
+    printf("operations (80%% search, 10%% insert, 10%% delete) and then deletes the IDs.\n");
+    printf("  Largest size exponent k (3-7): ");
+    int maxExp = getInt();
+    if (maxExp < 3 || maxExp > 7) {
+        printf("!! Exponent must be between 3 and 7.\n");
+        return;
+    }
+    InventoryEngine* engines[] = {&bstEngine, &avlEngine, &treapEngine, &skipEngine, &artEngine};
+    int patterns[] = {PATTERN_RANDOM, PATTERN_SEQUENTIAL, PATTERN_REVERSE, PATTERN_ZIPF};
+
+    for (int p = 0; p < 4; p++) {
+        int pattern = patterns[p];
+        printf("\nWorkload: %s IDs\n", patternNames[pattern]);
+        printf("+----------+-------+-----------+-----------+-----------+--------+------------+----------+\n");
+        printf("|        n | Eng.  | Insert ns | Mix ns/op | Delete ns | Height | Rotations  | B/item   |\n");
+        printf("+----------+-------+-----------+-----------+-----------+--------+------------+----------+\n");
+        int n = 1000;
+        for (int e10 = 3; e10 <= maxExp; e10++, n *= 10) {
+            int* keys = generateWorkloadKeys(pattern, 2 * n, 1234u + pattern);
+            int* extra = keys + n;
+            for (int e = 0; e < 5; e++) {
+                if (engines[e] == &bstEngine && n > BST_DEGENERATE_LIMIT
+                    && (pattern == PATTERN_SEQUENTIAL || pattern == PATTERN_REVERSE)) {
+                    printf("| %8d | %-5s | skipped: degenerate O(n^2) chain above %d IDs             |\n",
+                           n, engines[e]->name, BST_DEGENERATE_LIMIT);
+                    continue;
+                }
+                MixResult r = runEngineMix(engines[e], keys, extra, n, 77u + e10);
+                char rotations[16];
+                if (TREE_STATS && (engines[e] == &avlEngine || engines[e] == &treapEngine))
+                    snprintf(rotations, sizeof(rotations), "%ld", r.rotations);
+                else
+                    strcpy(rotations, "-");
+                printf("| %8d | %-5s | %9.1f | %9.1f | %9.1f | %6d | %10s | %8.1f |\n",
+                       n, engines[e]->name, r.insertNs, r.mixNs, r.deleteNs, r.height, rotations, r.bytesPerItem);
+            }
+            free(keys);
+        }
+        printf("+----------+-------+-----------+-----------+-----------+--------+------------+----------+\n");
+    }
+    printf("Height is tree height after the insert phase (levels for the skip list, depth for ART).\n");
+    if (!TREE_STATS)
+        printf("Rotations are counted only in builds with -DTREE_STATS=1.\n");
+    printf("B/item is payload + structure bytes per stored medicine (Medicine itself is %d bytes).\n",
+           (int)sizeof(Medicine));
+}
+
+void treeStatsDemo() {
+    printf("\n--- Tree Operation Statistics (AVL) ---\n");
+    if (!TREE_STATS) {
+        printf("!! Statistics are compiled out. Rebuild with -DTREE_STATS=1 to enable them.\n");
+        return;
+    }
+    printf("  Number of random operations: ");
+    int ops = getInt();
+    printf("  Sample tree height every N operations: ");
+    int sampleEvery = getInt();
+    printf("  Print a periodic dump every N operations (0 = never): ");
+    int dumpEvery = getInt();
+    if (ops <= 0 || sampleEvery <= 0 || dumpEvery < 0) {
+        printf("!! Invalid counts.\n");
+        return;
+    }
+
+    NameIndex names;
+    nameIndex_init(&names);
+    treeStats_reset(sampleEvery, dumpEvery);
+    Node* root = NULL;
+    unsigned int seed = 4242;
+    int keySpace = ops;
+    for (int i = 0; i < ops; i++) {
+        unsigned int roll = nextRandom(&seed);
+        int id = (int)((roll >> 4) % (unsigned int)keySpace);
+        if (roll % 10 < 5) {
+            Medicine m = {"", 10, 1.5f};
+            snprintf(m.name, sizeof(m.name), "Med-%d", id);
+            root = inventoryInsert(root, &names, id, m, 1);
+        } else if (roll % 10 < 8) {
+            search(root, id);
+            treeStats_tick(root);
+        } else {
+            root = inventoryDelete(root, &names, id, 1);
+        }
+    }
+
+    TreeStats snap = treeStats_snapshot();
+    printf("\n== Final Snapshot ==\n");
+    treeStats_dump(stdout, "final");
+    printf("Height over time (every %d ops, most recent %d samples):\n  ", snap.sampleEvery, STATS_HISTORY);
+    int first = snap.historyCount > STATS_HISTORY ? snap.historyCount - STATS_HISTORY : 0;
+    for (int i = first; i < snap.historyCount; i++)
+        printf("%d ", snap.heightHistory[i % STATS_HISTORY]);
+    printf("\nFinal inventory: %d medicines, height %d.\n", nodeSize(root), height(root));
+
+    freeTree(root);
+    nameIndex_free(&names);
+}
+
+typedef struct ShardWorkerArgs {
+    ShardedInventory* inv;
+    int ops;
+    int readPercent;
+    int keySpace;
+    unsigned int seed;
+    long found;
+} ShardWorkerArgs;
+
+void* shardWorker(void* arg) {
+    ShardWorkerArgs* a = (ShardWorkerArgs*)arg;
+    Medicine m = {"Counter", 5, 3.0f};
+    Medicine out;
+    for (int i = 0; i < a->ops; i++) {
+        unsigned int roll = nextRandom(&a->seed);
+        int id = (int)((roll >> 8) % (unsigned int)a->keySpace);
+        if ((int)(roll % 100) < a->readPercent)
+            a->found += sharded_find(a->inv, id, &out);
+        else if (roll & 0x80)
+            sharded_insert(a->inv, id, m);
+        else
+            sharded_delete(a->inv, id);
+    }
+    return NULL;
+}
+
+double runShardedMix(int numShards, int routing, int threads, int readPercent, int keySpace, int opsPerThread) {
+    ShardedInventory* inv = (ShardedInventory*)malloc(sizeof(ShardedInventory));
+    sharded_init(inv, numShards, routing, 0, keySpace - 1);
+    Medicine m = {"Stock", 20, 4.0f};
+    for (int id = 0; id < keySpace; id += 2)
+        sharded_insert(inv, id, m);
+
+    pthread_t* tids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    ShardWorkerArgs* args = (ShardWorkerArgs*)calloc(threads, sizeof(ShardWorkerArgs));
+    double start = nowSeconds();
+    for (int t = 0; t < threads; t++) {
+        args[t].inv = inv;
+        args[t].ops = opsPerThread;
+        args[t].readPercent = readPercent;
+        args[t].keySpace = keySpace;
+        args[t].seed = 1000u + t * 7919u;
+        pthread_create(&tids[t], NULL, shardWorker, &args[t]);
+    }
+    for (int t = 0; t < threads; t++)
+        pthread_join(tids[t], NULL);
+    double elapsed = nowSeconds() - start;
+
+    OrderCheck check = {0, 0, 1};
+    int visited = sharded_forEachOrdered(inv, checkOrderVisit, &check);
+    if (!check.ordered || visited != sharded_size(inv))
+        printf("!! Warning: ordered k-way merge check failed.\n");
+
+    free(tids);
+    free(args);
+    sharded_destroy(inv);
+    free(inv);
+    return (double)threads * opsPerThread / elapsed;
+}
+
+void shardedBenchmark() {
+    printf("\n--- Sharded Concurrent Inventory (per-shard reader-writer locks) ---\n");
+    printf("  Number of shards (1-%d): ", MAX_SHARDS);
+    int shards = getInt();
+    printf("  Routing (1 = by ID range, 2 = by hash): ");
+    int routing = getInt() == 1 ? ROUTE_BY_RANGE : ROUTE_BY_HASH;
+    printf("  Maximum counter threads: ");
+    int maxThreads = getInt();
+    printf("  Medicine ID space: ");
+    int keySpace = getInt();
+    printf("  Operations per thread: ");
+    int ops = getInt();
+    if (shards < 1 || shards > MAX_SHARDS || maxThreads < 1 || keySpace < 2 || ops <= 0) {
+        printf("!! Invalid benchmark parameters.\n");
+        return;
+    }
+
+    int mixes[] = {90, 50};
+    printf("\nRouting: %s | Shards: %d | Single-lock baseline uses 1 shard\n",
+           routing == ROUTE_BY_RANGE ? "ID range" : "hash", shards);
+    printf("+---------+-----------+-------------------+-------------------+---------+\n");
+    printf("| Threads | Read/Wrt  | 1 shard (ops/sec) | %2d shards (ops/s) | Speedup |\n", shards);
+    printf("+---------+-----------+-------------------+-------------------+---------+\n");
+    for (int mix = 0; mix < 2; mix++) {
+        // Powers of two, then maxThreads itself if it is not one of them
+        for (int threads = 1; threads <= maxThreads;
+             threads = (threads < maxThreads && threads * 2 > maxThreads) ? maxThreads : threads * 2) {
+            double single = runShardedMix(1, routing, threads, mixes[mix], keySpace, ops);
+            double sharded = runShardedMix(shards, routing, threads, mixes[mix], keySpace, ops);
+            printf("| %7d | %3d/%-3d   | %17.0f | %17.0f | %6.2fx |\n", threads, mixes[mix],
+                   100 - mixes[mix], single, sharded, sharded / single);
+        }
+    }
+    printf("+---------+-----------+-------------------+-------------------+---------+\n");
+}
+
+void snapshotRestartDemo() {
+    printf("\n--- Snapshot Restart Demo (mmap + background rebuild) ---\n");
+    printf("  Catalog size: ");
+    int n = getInt();
+    if (n <= 0) {
+        printf("!! Size must be positive.\n");
+        return;
+    }
+    const char* path = "inventory_snapshot.bin";
+    MedicineRecord* items = generateCatalog(n, 1, 2);
+    if (items == NULL)
+        return;
+    Node* root = avl_bulkLoad(items, n);
+    free(items);
+
+    double start = nowSeconds();
+    if (!snapshot_save(root, path)) {
+        printf("!! Error: Could not write '%s'.\n", path);
+        freeTree(root);
+        return;
+    }
+    printf("-> Wrote %s (%d medicines) in %.1f ms.\n", path, n, (nowSeconds() - start) * 1000.0);
+    freeTree(root);
+    printf("-> Simulating a restart: in-memory tree discarded.\n");
+
+    MappedSnapshot snap;
+    start = nowSeconds();
+    if (!snapshot_open(path, &snap)) {
+        printf("!! Error: Could not map '%s'.\n", path);
+        return;
+    }
+    double openTime = nowSeconds() - start;
+    const Medicine* first = snapshot_find(&snap, 2 * (n / 2) + 1);
+    double firstLookup = nowSeconds() - start;
+
+    RebuildJob job = {&snap, NULL, 0.0, 0};
+    pthread_t tid;
+    pthread_create(&tid, NULL, snapshotRebuildThread, &job);
+
+    unsigned int seed = 99;
+    long served = 0, hits = 0;
+    while (!__atomic_load_n(&job.done, __ATOMIC_ACQUIRE)) {
+        for (int i = 0; i < 1024; i++) {
+            int id = 1 + (int)(nextRandom(&seed) % (unsigned int)(2 * n));
+            if (snapshot_find(&snap, id) != NULL)
+                hits++;
+        }
+        served += 1024;
+    }
+    pthread_join(tid, NULL);
+
+    printf("-> Snapshot mapped in %.3f ms; first lookup answered after %.3f ms (%.*s).\n",
+           openTime * 1000.0, firstLookup * 1000.0, (int)sizeof(first->name), first ? first->name : "not found");
+    printf("-> %ld lookups (%ld hits) served from the mapped file during the rebuild.\n", served, hits);
+    printf("-> Background rebuild produced a %d-item AVL (height %d) in %.1f ms.\n",
+           nodeSize(job.root), height(job.root), job.seconds * 1000.0);
+
+    snapshot_close(&snap);
+    freeTree(job.root);
+    remove(path);
+}
+
+void enginesMenu() {
+    int choice;
+    while (1) {
+        printf("\n--- Advanced Inventory Engines ---\n");
+        printf("1. Concurrent Reporting Demo (Persistent AVL)\n");
+        printf("2. Static Eytzinger Index Benchmark\n");
+        printf("3. Batched Lookup Benchmark (searchBatch)\n");
+        printf("4. Adaptive Radix Tree Benchmark (ART vs BST vs AVL)\n");
+        printf("5. Branch/HQ Set Operations (Union, Intersection, Difference)\n");
+        printf("6. Tree Operation Statistics\n");
+        printf("7. Sharded Concurrent Inventory Benchmark\n");
+        printf("8. Snapshot Restart Demo (mmap + background rebuild)\n");
+        printf("9. Back to Main Menu\n");
+        choice = getInt();
+
+        switch (choice) {
+            case 1:
+                concurrentSnapshotDemo();
+                break;
+            case 2:
+                eytzingerBenchmark();
+                break;
+            case 3:
+                batchLookupBenchmark();
+                break;
+            case 4:
+                artBenchmark();
+                break;
+            case 5:
+                setOperationsBenchmark();
+                break;
+            case 6:
+                treeStatsDemo();
+                break;
+            case 7:
+                shardedBenchmark();
+                break;
+            case 8:
+                snapshotRestartDemo();
+                break;
+            case 9:
+                return;
+            default:
+                printf("!! Invalid choice.\n");
+        }
+        pressEnterToContinue();
+    }
 }
 
 int main() {
     Node* bstRoot = NULL;
     Node* avlRoot = NULL;
+    NameIndex bstNames, avlNames;
+    nameIndex_init(&bstNames);
+    nameIndex_init(&avlNames);
     int choice;
 
     while (1) {
         printf("\n===== BST & AVL Tree Pharmacy System =====\n");
         printf("1. Work with Binary Search Tree (BST)\n");
         printf("2. Work with AVL Tree\n");
-        printf("3. Compare Time Complexities (BST vs AVL)\n"); 
-        printf("4. Exit\n");                                 
+        printf("3. Benchmark Engines (BST, AVL, Treap, Skip List, ART)\n");
+        printf("4. Advanced Inventory Engines\n");
+        printf("5. Exit\n");                                 
 
         choice = getInt();
 
         switch (choice) {
             case 1:
-                handleTree(&bstRoot, 0);
+                handleTree(&bstRoot, &bstNames, 0);
                 break;
             case 2:
-                handleTree(&avlRoot, 1);
+                handleTree(&avlRoot, &avlNames, 1);
                 break;
             case 3: 
-                compareComplexities();
+                benchmarkEngines();
+                pressEnterToContinue();
+                break;
+            case 4:
+                enginesMenu();
                 break;
-            case 4: 
+            case 5: 
                 printf("Exiting. Freeing all tree memory...\n");
                 freeTree(bstRoot);
                 freeTree(avlRoot);
+                nameIndex_free(&bstNames);
+                nameIndex_free(&avlNames);
                 return 0;
             default:
                 printf("!! Invalid selection. Please try again.\n");
@@ -1,5 +1,14 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sched.h>
 
 typedef struct QueueNode {
     int data;
@@ -47,271 +56,3848 @@ typedef struct AdjListNode {
     struct AdjListNode* next;
 } AdjListNode;
 
+typedef struct IntVec {
+    int* items;
+    int count;
+    int capacity;
+} IntVec;
+
+typedef struct IncrementalTopo {
+    int V;
+    int* ord;
+    int* vertexAt;
+    IntVec* out;
+    IntVec* in;
+    int* visitStamp;
+    int stamp;
+    IntVec stack;
+    IntVec deltaF;
+    IntVec deltaB;
+    IntVec merged;
+    long inserted;
+    long rejected;
+    long reordered;
+    long visited;
+} IncrementalTopo;
+
 typedef struct Graph {
     int V;
-    AdjListNode** adj;
+    int E;
+    int edgeCapacity;
+    int* edgeSrc;
+    int* edgeDest;
+    int frozenEdges;
+    int* offsets;
+    int* targets;
+    int transposedEdges;
+    int* inOffsets;
+    int* sources;
     int* in_degree;
+    IncrementalTopo* online;
+    int* originalId;
+    int* internalId;
 } Graph;
 
-void clearInputBuffer() {
-    int c;
-    while ((c = getchar()) != '\n' && c != EOF);
+void clearInputBuffer() {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+}
+
+int getInt() {
+    int value, result;
+    do {
+        printf("> ");
+        result = scanf("%d", &value);
+        if (result != 1) {
+            printf("!! Invalid input. Please enter an integer.\n");
+            clearInputBuffer();
+        } else {
+            clearInputBuffer();
+            return value;
+        }
+    } while (1);
+}
+
+double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void intVec_push(IntVec* vec, int value) {
+    if (vec->count == vec->capacity) {
+        vec->capacity = vec->capacity ? vec->capacity * 2 : 4;
+        vec->items = (int*)realloc(vec->items, vec->capacity * sizeof(int));
+        if (vec->items == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    vec->items[vec->count++] = value;
+}
+
+int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+IncrementalTopo* topo_create(int V, int* initialOrder) {
+    IncrementalTopo* topo = (IncrementalTopo*)calloc(1, sizeof(IncrementalTopo));
+    topo->V = V;
+    topo->ord = (int*)malloc(V * sizeof(int));
+    topo->vertexAt = (int*)malloc(V * sizeof(int));
+    topo->out = (IntVec*)calloc(V, sizeof(IntVec));
+    topo->in = (IntVec*)calloc(V, sizeof(IntVec));
+    topo->visitStamp = (int*)calloc(V, sizeof(int));
+    if (topo->ord == NULL || topo->vertexAt == NULL || topo->out == NULL ||
+        topo->in == NULL || topo->visitStamp == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int i = 0; i < V; i++) {
+        topo->vertexAt[i] = initialOrder[i];
+        topo->ord[initialOrder[i]] = i;
+    }
+    return topo;
+}
+
+void topo_free(IncrementalTopo* topo) {
+    if (topo == NULL) return;
+    for (int v = 0; v < topo->V; v++) {
+        free(topo->out[v].items);
+        free(topo->in[v].items);
+    }
+    free(topo->out);
+    free(topo->in);
+    free(topo->ord);
+    free(topo->vertexAt);
+    free(topo->visitStamp);
+    free(topo->stack.items);
+    free(topo->deltaF.items);
+    free(topo->deltaB.items);
+    free(topo->merged.items);
+    free(topo);
+}
+
+int topo_forward(IncrementalTopo* topo, int start, int upperBound) {
+    topo->stack.count = 0;
+    topo->deltaF.count = 0;
+    topo->visitStamp[start] = topo->stamp;
+    intVec_push(&topo->stack, start);
+    while (topo->stack.count > 0) {
+        int v = topo->stack.items[--topo->stack.count];
+        intVec_push(&topo->deltaF, topo->ord[v]);
+        IntVec* edges = &topo->out[v];
+        for (int i = 0; i < edges->count; i++) {
+            int w = edges->items[i];
+            if (topo->ord[w] == upperBound) return 0;
+            if (topo->visitStamp[w] != topo->stamp && topo->ord[w] < upperBound) {
+                topo->visitStamp[w] = topo->stamp;
+                intVec_push(&topo->stack, w);
+            }
+        }
+    }
+    return 1;
+}
+
+void topo_backward(IncrementalTopo* topo, int start, int lowerBound) {
+    topo->stack.count = 0;
+    topo->deltaB.count = 0;
+    topo->visitStamp[start] = topo->stamp;
+    intVec_push(&topo->stack, start);
+    while (topo->stack.count > 0) {
+        int v = topo->stack.items[--topo->stack.count];
+        intVec_push(&topo->deltaB, topo->ord[v]);
+        IntVec* edges = &topo->in[v];
+        for (int i = 0; i < edges->count; i++) {
+            int w = edges->items[i];
+            if (topo->visitStamp[w] != topo->stamp && topo->ord[w] > lowerBound) {
+                topo->visitStamp[w] = topo->stamp;
+                intVec_push(&topo->stack, w);
+            }
+        }
+    }
+}
+
+void topo_reorder(IncrementalTopo* topo) {
+    IntVec* deltaB = &topo->deltaB;
+    IntVec* deltaF = &topo->deltaF;
+    qsort(deltaB->items, deltaB->count, sizeof(int), compareInts);
+    qsort(deltaF->items, deltaF->count, sizeof(int), compareInts);
+
+    topo->merged.count = 0;
+    for (int i = 0; i < deltaB->count; i++)
+        intVec_push(&topo->merged, topo->vertexAt[deltaB->items[i]]);
+    for (int i = 0; i < deltaF->count; i++)
+        intVec_push(&topo->merged, topo->vertexAt[deltaF->items[i]]);
+
+    int i = 0, j = 0, k = 0;
+    while (i < deltaB->count || j < deltaF->count) {
+        int slot;
+        if (j == deltaF->count || (i < deltaB->count && deltaB->items[i] < deltaF->items[j]))
+            slot = deltaB->items[i++];
+        else
+            slot = deltaF->items[j++];
+        int v = topo->merged.items[k++];
+        topo->ord[v] = slot;
+        topo->vertexAt[slot] = v;
+    }
+}
+
+int topo_insertEdge(IncrementalTopo* topo, int src, int dest) {
+    if (src == dest) {
+        topo->rejected++;
+        return 0;
+    }
+    int lowerBound = topo->ord[dest];
+    int upperBound = topo->ord[src];
+    if (lowerBound < upperBound) {
+        topo->stamp++;
+        if (!topo_forward(topo, dest, upperBound)) {
+            topo->visited += topo->deltaF.count;
+            topo->rejected++;
+            return 0;
+        }
+        topo_backward(topo, src, lowerBound);
+        topo->visited += topo->deltaF.count + topo->deltaB.count;
+        topo_reorder(topo);
+        topo->reordered++;
+    }
+    intVec_push(&topo->out[src], dest);
+    intVec_push(&topo->in[dest], src);
+    topo->inserted++;
+    return 1;
+}
+
+Graph* createGraph(int V) {
+    Graph* graph = (Graph*)malloc(sizeof(Graph));
+    graph->V = V;
+    graph->E = 0;
+    graph->edgeCapacity = 16;
+    graph->edgeSrc = (int*)malloc(graph->edgeCapacity * sizeof(int));
+    graph->edgeDest = (int*)malloc(graph->edgeCapacity * sizeof(int));
+    graph->frozenEdges = -1;
+    graph->offsets = NULL;
+    graph->targets = NULL;
+    graph->transposedEdges = -1;
+    graph->inOffsets = NULL;
+    graph->sources = NULL;
+    graph->online = NULL;
+    graph->originalId = NULL;
+    graph->internalId = NULL;
+
+    graph->in_degree = (int*)calloc(V, sizeof(int));
+
+    return graph;
+}
+
+int displayId(Graph* graph, int v) {
+    return graph->originalId != NULL ? graph->originalId[v] : v;
+}
+
+int lookupId(Graph* graph, int id) {
+    if (id < 0 || id >= graph->V) return -1;
+    return graph->internalId != NULL ? graph->internalId[id] : id;
+}
+
+int appendEdge(Graph* graph, int src, int dest) {
+    if (src >= graph->V || dest >= graph->V || src < 0 || dest < 0)
+        return 0;
+    if (graph->online != NULL && !topo_insertEdge(graph->online, src, dest))
+        return -1;
+    if (graph->E == graph->edgeCapacity) {
+        graph->edgeCapacity *= 2;
+        graph->edgeSrc = (int*)realloc(graph->edgeSrc, graph->edgeCapacity * sizeof(int));
+        graph->edgeDest = (int*)realloc(graph->edgeDest, graph->edgeCapacity * sizeof(int));
+        if (graph->edgeSrc == NULL || graph->edgeDest == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    graph->edgeSrc[graph->E] = src;
+    graph->edgeDest[graph->E] = dest;
+    graph->E++;
+    graph->in_degree[dest]++;
+    return 1;
+}
+
+void addEdge(Graph* graph, int src, int dest) {
+    int status = appendEdge(graph, lookupId(graph, src), lookupId(graph, dest));
+    if (status == 0) {
+        printf("!! Invalid vertex number.\n");
+        return;
+    }
+    if (status < 0) {
+        printf("!! Edge from %d to %d would create a cycle. Rejected.\n", src, dest);
+        return;
+    }
+    printf("-> Edge from %d to %d added.\n", src, dest);
+}
+
+void freezeGraph(Graph* graph) {
+    int V = graph->V;
+    free(graph->offsets);
+    free(graph->targets);
+    graph->offsets = (int*)calloc(V + 1, sizeof(int));
+    graph->targets = (int*)malloc((graph->E > 0 ? graph->E : 1) * sizeof(int));
+    int* cursor = (int*)malloc((V + 1) * sizeof(int));
+    if (graph->offsets == NULL || graph->targets == NULL || cursor == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+
+    for (int e = 0; e < graph->E; e++)
+        graph->offsets[graph->edgeSrc[e] + 1]++;
+    for (int v = 0; v < V; v++)
+        graph->offsets[v + 1] += graph->offsets[v];
+    memcpy(cursor, graph->offsets, (V + 1) * sizeof(int));
+    for (int e = graph->E - 1; e >= 0; e--)
+        graph->targets[cursor[graph->edgeSrc[e]]++] = graph->edgeDest[e];
+
+    free(cursor);
+    graph->frozenEdges = graph->E;
+}
+
+void ensureFrozen(Graph* graph) {
+    if (graph->frozenEdges != graph->E)
+        freezeGraph(graph);
+}
+
+void ensureTransposed(Graph* graph) {
+    if (graph->transposedEdges == graph->E) return;
+    ensureFrozen(graph);
+    int V = graph->V;
+    free(graph->inOffsets);
+    free(graph->sources);
+    graph->inOffsets = (int*)malloc((V + 1) * sizeof(int));
+    graph->sources = (int*)malloc((graph->E > 0 ? graph->E : 1) * sizeof(int));
+    int* cursor = (int*)malloc(V * sizeof(int));
+    if (graph->inOffsets == NULL || graph->sources == NULL || cursor == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+
+    graph->inOffsets[0] = 0;
+    for (int v = 0; v < V; v++)
+        graph->inOffsets[v + 1] = graph->inOffsets[v] + graph->in_degree[v];
+    memcpy(cursor, graph->inOffsets, V * sizeof(int));
+    for (int u = 0; u < V; u++)
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++)
+            graph->sources[cursor[graph->targets[e]]++] = u;
+
+    free(cursor);
+    graph->transposedEdges = graph->E;
+}
+
+void freeGraph(Graph* graph) {
+    if (graph == NULL) return;
+    free(graph->edgeSrc);
+    free(graph->edgeDest);
+    free(graph->offsets);
+    free(graph->targets);
+    free(graph->inOffsets);
+    free(graph->sources);
+    topo_free(graph->online);
+    free(graph->originalId);
+    free(graph->internalId);
+    free(graph->in_degree);
+    free(graph);
+}
+
+void printGraph(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    ensureFrozen(graph);
+    printf("\n--- Graph Adjacency List ---\n");
+    for (int v = 0; v < graph->V; ++v) {
+        printf("Vertex %d (in-degree: %d): ", displayId(graph, v), graph->in_degree[v]);
+        for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++)
+            printf("-> %d ", displayId(graph, graph->targets[e]));
+        printf("\n");
+    }
+}
+
+typedef int (*DFSVisitFn)(int v, void* ctx);
+typedef int (*DFSEdgeFn)(int v, int w, void* ctx);
+
+typedef struct DFSFrame {
+    int v;
+    int cursor;
+} DFSFrame;
+
+enum { DFS_WHITE, DFS_GRAY, DFS_BLACK };
+
+typedef struct DFSEngine {
+    Graph* graph;
+    unsigned char* color;
+    DFSFrame* stack;
+    int top;
+    int capacity;
+    DFSVisitFn preVisit;
+    DFSVisitFn postVisit;
+    DFSVisitFn backEdge;
+    DFSEdgeFn nonTreeEdge;
+    void* ctx;
+} DFSEngine;
+
+void dfs_init(DFSEngine* dfs, Graph* graph, DFSVisitFn preVisit, DFSVisitFn postVisit,
+              DFSVisitFn backEdge, void* ctx) {
+    ensureFrozen(graph);
+    dfs->graph = graph;
+    dfs->color = (unsigned char*)calloc(graph->V, 1);
+    dfs->capacity = 64;
+    dfs->stack = (DFSFrame*)malloc(dfs->capacity * sizeof(DFSFrame));
+    if (dfs->color == NULL || dfs->stack == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    dfs->top = 0;
+    dfs->preVisit = preVisit;
+    dfs->postVisit = postVisit;
+    dfs->backEdge = backEdge;
+    dfs->nonTreeEdge = NULL;
+    dfs->ctx = ctx;
+}
+
+int dfs_push(DFSEngine* dfs, int v) {
+    if (dfs->top == dfs->capacity) {
+        dfs->capacity *= 2;
+        dfs->stack = (DFSFrame*)realloc(dfs->stack, dfs->capacity * sizeof(DFSFrame));
+        if (dfs->stack == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    dfs->color[v] = DFS_GRAY;
+    dfs->stack[dfs->top].v = v;
+    dfs->stack[dfs->top].cursor = dfs->graph->offsets[v];
+    dfs->top++;
+    return dfs->preVisit != NULL && dfs->preVisit(v, dfs->ctx);
+}
+
+int dfs_visit(DFSEngine* dfs, int root) {
+    int* offsets = dfs->graph->offsets;
+    int* targets = dfs->graph->targets;
+    if (dfs_push(dfs, root)) return 1;
+    while (dfs->top > 0) {
+        DFSFrame* frame = &dfs->stack[dfs->top - 1];
+        if (frame->cursor < offsets[frame->v + 1]) {
+            int w = targets[frame->cursor++];
+            if (dfs->color[w] == DFS_WHITE) {
+                if (dfs_push(dfs, w)) return 1;
+            } else {
+                if (dfs->color[w] == DFS_GRAY && dfs->backEdge != NULL && dfs->backEdge(w, dfs->ctx))
+                    return 1;
+                if (dfs->nonTreeEdge != NULL && dfs->nonTreeEdge(frame->v, w, dfs->ctx))
+                    return 1;
+            }
+        } else {
+            int v = frame->v;
+            dfs->top--;
+            dfs->color[v] = DFS_BLACK;
+            if (dfs->postVisit != NULL && dfs->postVisit(v, dfs->ctx)) return 1;
+        }
+    }
+    return 0;
+}
+
+int dfs_parent(DFSEngine* dfs) {
+    return dfs->top > 0 ? dfs->stack[dfs->top - 1].v : -1;
+}
+
+int dfs_all(DFSEngine* dfs) {
+    for (int i = 0; i < dfs->graph->V; i++)
+        if (dfs->color[i] == DFS_WHITE && dfs_visit(dfs, i))
+            return 1;
+    return 0;
+}
+
+void dfs_free(DFSEngine* dfs) {
+    free(dfs->color);
+    free(dfs->stack);
+}
+
+typedef struct OrderBuffer {
+    int* order;
+    int count;
+} OrderBuffer;
+
+int appendVisit(int v, void* ctx) {
+    OrderBuffer* buf = (OrderBuffer*)ctx;
+    buf->order[buf->count++] = v;
+    return 0;
+}
+
+int stopOnBackEdge(int v, void* ctx) {
+    (void)v;
+    (void)ctx;
+    return 1;
+}
+
+int DFT_order(Graph* graph, int* order) {
+    OrderBuffer buf = { order, 0 };
+    DFSEngine dfs;
+    dfs_init(&dfs, graph, appendVisit, NULL, NULL, &buf);
+    dfs_all(&dfs);
+    dfs_free(&dfs);
+    return buf.count;
+}
+
+void printOrder(Graph* graph, const char* label, int* order, int count) {
+    printf("%s: ", label);
+    for (int i = 0; i < count; i++)
+        printf("%d ", displayId(graph, order[i]));
+    printf("\n");
+}
+
+void DFT(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    int count = DFT_order(graph, order);
+    printOrder(graph, "Depth First Traversal", order, count);
+    free(order);
+}
+
+int BFT_order(Graph* graph, int* order) {
+    ensureFrozen(graph);
+    int* visited = (int*)calloc(graph->V, sizeof(int));
+    int head = 0, tail = 0;
+    for (int i = 0; i < graph->V; i++) {
+        if (!visited[i]) {
+            visited[i] = 1;
+            order[tail++] = i;
+            while (head < tail) {
+                int v = order[head++];
+                for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+                    int w = graph->targets[e];
+                    if (!visited[w]) {
+                        visited[w] = 1;
+                        order[tail++] = w;
+                    }
+                }
+            }
+        }
+    }
+    free(visited);
+    return tail;
+}
+
+void BFT(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    int count = BFT_order(graph, order);
+    printOrder(graph, "Breadth First Traversal", order, count);
+    free(order);
+}
+
+int isDAG_DFT(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return 0;
+    }
+    DFSEngine dfs;
+    dfs_init(&dfs, graph, NULL, NULL, stopOnBackEdge, NULL);
+    int cyclic = dfs_all(&dfs);
+    dfs_free(&dfs);
+    return !cyclic;
+}
+
+int topoSort_DFT_order(Graph* graph, int* order) {
+    OrderBuffer buf = { order, 0 };
+    DFSEngine dfs;
+    dfs_init(&dfs, graph, NULL, appendVisit, stopOnBackEdge, &buf);
+    int cyclic = dfs_all(&dfs);
+    dfs_free(&dfs);
+    if (cyclic) return 0;
+    for (int i = 0, j = buf.count - 1; i < j; i++, j--) {
+        int t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    return 1;
+}
+
+void topologicalSort_DFT(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    if (!topoSort_DFT_order(graph, order)) {
+        printf("!! Error: Graph contains a cycle. Topological sort not possible.\n");
+        free(order);
+        return;
+    }
+    printf("Topological Sort (DFT-Based): ");
+    for (int i = 0; i < graph->V; i++)
+        printf("%d ", displayId(graph, order[i]));
+    printf("\n");
+    free(order);
+}
+
+int kahn_order(Graph* graph, int* order) {
+    ensureFrozen(graph);
+    int* in_degree_copy = (int*)malloc(graph->V * sizeof(int));
+    memcpy(in_degree_copy, graph->in_degree, graph->V * sizeof(int));
+
+    int head = 0, tail = 0;
+    for (int i = 0; i < graph->V; i++)
+        if (in_degree_copy[i] == 0)
+            order[tail++] = i;
+
+    while (head < tail) {
+        int u = order[head++];
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int w = graph->targets[e];
+            if (--in_degree_copy[w] == 0)
+                order[tail++] = w;
+        }
+    }
+
+    free(in_degree_copy);
+    return tail;
+}
+
+int topologicalSort_Kahn(Graph* graph, int printSort) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return 0;
+    }
+    int* sortedOrder = (int*)malloc(graph->V * sizeof(int));
+    int count = kahn_order(graph, sortedOrder);
+
+    if (count != graph->V) {
+        if(printSort) printf("!! Error: Graph contains a cycle. Topological sort not possible.\n");
+        free(sortedOrder);
+        return 0;
+    }
+
+    if (printSort) {
+        printf("Topological Sort (Kahn's): ");
+        for (int i = 0; i < graph->V; i++)
+            printf("%d ", displayId(graph, sortedOrder[i]));
+        printf("\n");
+    }
+
+    free(sortedOrder);
+    return 1;
+}
+
+typedef struct SCCResult {
+    int count;
+    int* comp;
+    int* compSize;
+    int* memberOffsets;
+    int* members;
+    Graph* condensation;
+} SCCResult;
+
+typedef struct TarjanState {
+    DFSEngine* dfs;
+    int* index;
+    int* low;
+    unsigned char* onStack;
+    int* stack;
+    int top;
+    int counter;
+    int* comp;
+    int count;
+} TarjanState;
+
+int tarjanPreVisit(int v, void* ctx) {
+    TarjanState* st = (TarjanState*)ctx;
+    st->index[v] = st->low[v] = st->counter++;
+    st->stack[st->top++] = v;
+    st->onStack[v] = 1;
+    return 0;
+}
+
+int tarjanNonTreeEdge(int v, int w, void* ctx) {
+    TarjanState* st = (TarjanState*)ctx;
+    if (st->onStack[w] && st->index[w] < st->low[v])
+        st->low[v] = st->index[w];
+    return 0;
+}
+
+int tarjanPostVisit(int v, void* ctx) {
+    TarjanState* st = (TarjanState*)ctx;
+    if (st->low[v] == st->index[v]) {
+        int w;
+        do {
+            w = st->stack[--st->top];
+            st->onStack[w] = 0;
+            st->comp[w] = st->count;
+        } while (w != v);
+        st->count++;
+    }
+    int parent = dfs_parent(st->dfs);
+    if (parent >= 0 && st->low[v] < st->low[parent])
+        st->low[parent] = st->low[v];
+    return 0;
+}
+
+void scc_tarjan(Graph* graph, SCCResult* result) {
+    int V = graph->V;
+    DFSEngine dfs;
+    TarjanState st;
+    dfs_init(&dfs, graph, tarjanPreVisit, tarjanPostVisit, NULL, &st);
+    dfs.nonTreeEdge = tarjanNonTreeEdge;
+    st.dfs = &dfs;
+    st.index = (int*)malloc(V * sizeof(int));
+    st.low = (int*)malloc(V * sizeof(int));
+    st.onStack = (unsigned char*)calloc(V, 1);
+    st.stack = (int*)malloc(V * sizeof(int));
+    st.comp = (int*)malloc(V * sizeof(int));
+    if (st.index == NULL || st.low == NULL || st.onStack == NULL || st.stack == NULL || st.comp == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    st.top = 0;
+    st.counter = 0;
+    st.count = 0;
+    dfs_all(&dfs);
+    dfs_free(&dfs);
+    free(st.index);
+    free(st.low);
+    free(st.onStack);
+    free(st.stack);
+
+    int count = st.count;
+    result->count = count;
+    result->comp = st.comp;
+    result->compSize = (int*)calloc(count, sizeof(int));
+    result->memberOffsets = (int*)calloc(count + 1, sizeof(int));
+    result->members = (int*)malloc(V * sizeof(int));
+    for (int v = 0; v < V; v++) {
+        st.comp[v] = count - 1 - st.comp[v];
+        result->compSize[st.comp[v]]++;
+    }
+    for (int c = 0; c < count; c++)
+        result->memberOffsets[c + 1] = result->memberOffsets[c] + result->compSize[c];
+    int* cursor = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    memcpy(cursor, result->memberOffsets, count * sizeof(int));
+    for (int v = 0; v < V; v++)
+        result->members[cursor[st.comp[v]]++] = v;
+    free(cursor);
+    result->condensation = NULL;
+}
+
+void scc_buildCondensation(Graph* graph, SCCResult* result) {
+    Graph* dag = createGraph(result->count);
+    int* lastSeen = (int*)malloc((result->count > 0 ? result->count : 1) * sizeof(int));
+    for (int c = 0; c < result->count; c++)
+        lastSeen[c] = -1;
+    for (int c = 0; c < result->count; c++) {
+        for (int i = result->memberOffsets[c]; i < result->memberOffsets[c + 1]; i++) {
+            int u = result->members[i];
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+                int d = result->comp[graph->targets[e]];
+                if (d != c && lastSeen[d] != c) {
+                    lastSeen[d] = c;
+                    appendEdge(dag, c, d);
+                }
+            }
+        }
+    }
+    free(lastSeen);
+    freezeGraph(dag);
+    result->condensation = dag;
+}
+
+void scc_compute(Graph* graph, SCCResult* result) {
+    ensureFrozen(graph);
+    scc_tarjan(graph, result);
+    scc_buildCondensation(graph, result);
+}
+
+void scc_free(SCCResult* result) {
+    free(result->comp);
+    free(result->compSize);
+    free(result->memberOffsets);
+    free(result->members);
+    freeGraph(result->condensation);
+}
+
+int hasSelfLoop(Graph* graph, int v) {
+    for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++)
+        if (graph->targets[e] == v)
+            return 1;
+    return 0;
+}
+
+int isCyclicComponent(Graph* graph, SCCResult* result, int c) {
+    return result->compSize[c] > 1 || hasSelfLoop(graph, result->members[result->memberOffsets[c]]);
+}
+
+int findCycleInComponent(Graph* graph, SCCResult* result, int c, int* cycle) {
+    int start = result->members[result->memberOffsets[c]];
+    int size = result->compSize[c];
+    if (size == 1) {
+        cycle[0] = start;
+        return 1;
+    }
+    int* parent = (int*)malloc(graph->V * sizeof(int));
+    int* queue = (int*)malloc(size * sizeof(int));
+    for (int i = result->memberOffsets[c]; i < result->memberOffsets[c + 1]; i++)
+        parent[result->members[i]] = -2;
+    parent[start] = -1;
+    int head = 0, tail = 0, last = -1;
+    queue[tail++] = start;
+    while (head < tail && last < 0) {
+        int u = queue[head++];
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int w = graph->targets[e];
+            if (w == start) { last = u; break; }
+            if (result->comp[w] == c && parent[w] == -2) {
+                parent[w] = u;
+                queue[tail++] = w;
+            }
+        }
+    }
+    int length = 0;
+    for (int v = last; v != -1; v = parent[v])
+        cycle[length++] = v;
+    for (int i = 0, j = length - 1; i < j; i++, j--) {
+        int t = cycle[i]; cycle[i] = cycle[j]; cycle[j] = t;
+    }
+    free(parent);
+    free(queue);
+    return length;
+}
+
+#define SCC_PRINT_LIMIT 10
+#define SCC_CYCLE_PRINT_LIMIT 20
+
+void printComponentCycles(Graph* graph, SCCResult* result) {
+    int cyclic = 0;
+    int* cycle = (int*)malloc(graph->V * sizeof(int));
+    for (int c = 0; c < result->count; c++) {
+        if (!isCyclicComponent(graph, result, c)) continue;
+        cyclic++;
+        if (cyclic > SCC_PRINT_LIMIT) continue;
+        printf("Component %d (size %d): ", c, result->compSize[c]);
+        for (int i = 0; i < result->compSize[c] && i < SCC_CYCLE_PRINT_LIMIT; i++)
+            printf("%d ", displayId(graph, result->members[result->memberOffsets[c] + i]));
+        if (result->compSize[c] > SCC_CYCLE_PRINT_LIMIT) printf("...");
+        int length = findCycleInComponent(graph, result, c, cycle);
+        printf("\n   Cycle: ");
+        for (int i = 0; i < length && i < SCC_CYCLE_PRINT_LIMIT; i++)
+            printf("%d -> ", displayId(graph, cycle[i]));
+        if (length > SCC_CYCLE_PRINT_LIMIT) printf("... -> ");
+        printf("%d\n", displayId(graph, cycle[0]));
+    }
+    if (cyclic > SCC_PRINT_LIMIT)
+        printf("... and %d more cyclic components.\n", cyclic - SCC_PRINT_LIMIT);
+    if (cyclic == 0)
+        printf("No cycles: every component is a single vertex.\n");
+    free(cycle);
+}
+
+void sccAnalysis(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    SCCResult result;
+    scc_compute(graph, &result);
+    printf("\n--- Strongly Connected Components ---\n");
+    printf("-> %d components; condensation DAG has %d edges.\n", result.count, result.condensation->E);
+    printComponentCycles(graph, &result);
+    scc_free(&result);
+}
+
+void topologicalSort_SCC(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    SCCResult result;
+    scc_compute(graph, &result);
+    printf("Topological Sort (SCC condensation): ");
+    for (int c = 0; c < result.count; c++) {
+        if (result.compSize[c] == 1) {
+            printf("%d ", displayId(graph, result.members[result.memberOffsets[c]]));
+            continue;
+        }
+        printf("{");
+        for (int i = result.memberOffsets[c]; i < result.memberOffsets[c + 1]; i++)
+            printf(i > result.memberOffsets[c] ? " %d" : "%d", displayId(graph, result.members[i]));
+        printf("} ");
+    }
+    printf("\n");
+    scc_free(&result);
+}
+
+typedef struct ReachIndex {
+    SCCResult scc;
+    int* post;
+    int* intervalOffsets;
+    int* intervalCount;
+    int* intervals;
+    long totalIntervals;
+} ReachIndex;
+
+typedef struct TreeCoverState {
+    int* post;
+    int* low;
+    int counter;
+} TreeCoverState;
+
+int treeCoverPreVisit(int v, void* ctx) {
+    TreeCoverState* st = (TreeCoverState*)ctx;
+    st->low[v] = st->counter;
+    return 0;
+}
+
+int treeCoverPostVisit(int v, void* ctx) {
+    TreeCoverState* st = (TreeCoverState*)ctx;
+    st->post[v] = st->counter++;
+    return 0;
+}
+
+int compareIntervals(const void* a, const void* b) {
+    const int* x = (const int*)a;
+    const int* y = (const int*)b;
+    return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+void reach_build(Graph* graph, ReachIndex* index) {
+    scc_compute(graph, &index->scc);
+    Graph* dag = index->scc.condensation;
+    int C = dag->V;
+
+    TreeCoverState st;
+    st.post = (int*)malloc((C > 0 ? C : 1) * sizeof(int));
+    st.low = (int*)malloc((C > 0 ? C : 1) * sizeof(int));
+    if (st.post == NULL || st.low == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    st.counter = 0;
+    DFSEngine dfs;
+    dfs_init(&dfs, dag, treeCoverPreVisit, treeCoverPostVisit, NULL, &st);
+    dfs_all(&dfs);
+    dfs_free(&dfs);
+
+    int capacity = 2 * C + 16;
+    int* pool = (int*)malloc(capacity * sizeof(int));
+    int bufferCapacity = 64;
+    int* buffer = (int*)malloc(bufferCapacity * sizeof(int));
+    index->intervalOffsets = (int*)malloc((C > 0 ? C : 1) * sizeof(int));
+    index->intervalCount = (int*)malloc((C > 0 ? C : 1) * sizeof(int));
+    if (pool == NULL || buffer == NULL || index->intervalOffsets == NULL || index->intervalCount == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    long used = 0;
+
+    for (int c = C - 1; c >= 0; c--) {
+        long needed = 2;
+        for (int e = dag->offsets[c]; e < dag->offsets[c + 1]; e++)
+            needed += 2L * index->intervalCount[dag->targets[e]];
+        if (needed > bufferCapacity) {
+            while (bufferCapacity < needed) bufferCapacity *= 2;
+            buffer = (int*)realloc(buffer, bufferCapacity * sizeof(int));
+            if (buffer == NULL) {
+                printf("!! Fatal Error: Memory allocation failed.\n");
+                exit(1);
+            }
+        }
+        int n = 0;
+        buffer[n++] = st.low[c];
+        buffer[n++] = st.post[c];
+        for (int e = dag->offsets[c]; e < dag->offsets[c + 1]; e++) {
+            int d = dag->targets[e];
+            int* list = pool + index->intervalOffsets[d];
+            for (int i = 0; i < index->intervalCount[d]; i++) {
+                int start = list[2 * i], end = list[2 * i + 1];
+                if (start >= st.low[c] && end <= st.post[c]) continue;
+                buffer[n++] = start;
+                buffer[n++] = end;
+            }
+        }
+        qsort(buffer, n / 2, 2 * sizeof(int), compareIntervals);
+        int merged = 0;
+        for (int i = 0; i < n; i += 2) {
+            if (merged > 0 && buffer[i] <= buffer[2 * (merged - 1) + 1] + 1) {
+                if (buffer[i + 1] > buffer[2 * (merged - 1) + 1])
+                    buffer[2 * (merged - 1) + 1] = buffer[i + 1];
+            } else {
+                buffer[2 * merged] = buffer[i];
+                buffer[2 * merged + 1] = buffer[i + 1];
+                merged++;
+            }
+        }
+        if (used + 2L * merged > capacity) {
+            while (used + 2L * merged > capacity) capacity *= 2;
+            pool = (int*)realloc(pool, (size_t)capacity * sizeof(int));
+            if (pool == NULL) {
+                printf("!! Fatal Error: Memory allocation failed.\n");
+                exit(1);
+            }
+        }
+        memcpy(pool + used, buffer, 2 * merged * sizeof(int));
+        index->intervalOffsets[c] = (int)used;
+        index->intervalCount[c] = merged;
+        used += 2L * merged;
+    }
+
+    free(buffer);
+    free(st.low);
+    index->post = st.post;
+    index->intervals = (int*)realloc(pool, (used > 0 ? used : 1) * sizeof(int));
+    if (index->intervals == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    index->totalIntervals = used / 2;
+}
+
+int reach_query(ReachIndex* index, int u, int v) {
+    int c = index->scc.comp[u];
+    int d = index->scc.comp[v];
+    if (c == d) return 1;
+    if (c > d) return 0;
+    int p = index->post[d];
+    int* list = index->intervals + index->intervalOffsets[c];
+    int lo = 0, hi = index->intervalCount[c] - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        if (list[2 * mid] <= p) {
+            if (p <= list[2 * mid + 1]) return 1;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return 0;
+}
+
+size_t reach_memoryBytes(ReachIndex* index, int V) {
+    size_t C = index->scc.count;
+    return (size_t)V * sizeof(int) + C * 3 * sizeof(int) + (size_t)index->totalIntervals * 2 * sizeof(int);
+}
+
+void reach_free(ReachIndex* index) {
+    scc_free(&index->scc);
+    free(index->post);
+    free(index->intervalOffsets);
+    free(index->intervalCount);
+    free(index->intervals);
+}
+
+int enableOnlineTopo(Graph* graph) {
+    if (graph->online != NULL) return 1;
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    if (kahn_order(graph, order) != graph->V) {
+        free(order);
+        return 0;
+    }
+    IncrementalTopo* topo = topo_create(graph->V, order);
+    for (int e = 0; e < graph->E; e++) {
+        intVec_push(&topo->out[graph->edgeSrc[e]], graph->edgeDest[e]);
+        intVec_push(&topo->in[graph->edgeDest[e]], graph->edgeSrc[e]);
+    }
+    free(order);
+    graph->online = topo;
+    return 1;
+}
+
+void printOnlineOrder(Graph* graph) {
+    printf("Current topological order: ");
+    for (int i = 0; i < graph->V; i++)
+        printf("%d ", displayId(graph, graph->online->vertexAt[i]));
+    printf("\n");
+}
+
+void onlineTopoMode(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    if (!enableOnlineTopo(graph)) {
+        printf("!! Error: Graph already contains a cycle. Online ordering needs a DAG.\n");
+        return;
+    }
+    printf("\n--- Online Topological Order ---\n");
+    printf("Edges that would close a cycle are rejected. Type '-1 -1' to stop.\n");
+    printOnlineOrder(graph);
+    while (1) {
+        int src, dest;
+        printf("Edge (src dest): ");
+        if (scanf("%d %d", &src, &dest) != 2) {
+            clearInputBuffer();
+            break;
+        }
+        clearInputBuffer();
+        if (src == -1 || dest == -1) break;
+        addEdge(graph, src, dest);
+        printOnlineOrder(graph);
+    }
+    IncrementalTopo* topo = graph->online;
+    printf("-> %ld edges accepted, %ld rejected, %ld reorders touching %ld vertices.\n",
+           topo->inserted, topo->rejected, topo->reordered, topo->visited);
+}
+
+#define MAX_THREADS 64
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+#define BFS_CHUNK 64
+#define BFS_LOCAL_BUFFER 256
+
+int defaultThreadCount() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > MAX_THREADS) n = MAX_THREADS;
+    return (int)n;
+}
+
+typedef struct BFSResult {
+    int* order;
+    int* level;
+    int count;
+    int levels;
+    int bottomUpSteps;
+    long edgesExamined;
+} BFSResult;
+
+typedef struct ParallelBFS {
+    Graph* graph;
+    int threads;
+    int allowBottomUp;
+    uint64_t* visited;
+    uint64_t* frontierBits;
+    int* order;
+    int* level;
+    int head;
+    int tail;
+    int nextTail;
+    int nextChunk;
+    int currentLevel;
+    int bottomUp;
+    int bottomUpSteps;
+    int maxLevel;
+    long edgesExamined;
+    long frontierEdges;
+    long exploredInEdges;
+    long unexploredEdges;
+    int done;
+    pthread_t workers[MAX_THREADS];
+    pthread_barrier_t barrier;
+} ParallelBFS;
+
+int testBit(const uint64_t* bits, int v) {
+    return (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+int claimVertex(uint64_t* bits, int v) {
+    uint64_t mask = (uint64_t)1 << (v & 63);
+    if (__atomic_load_n(&bits[v >> 6], __ATOMIC_RELAXED) & mask) return 0;
+    return !(__atomic_fetch_or(&bits[v >> 6], mask, __ATOMIC_RELAXED) & mask);
+}
+
+void bfsFlush(ParallelBFS* bfs, int* local, int* n) {
+    if (*n == 0) return;
+    int pos = __atomic_fetch_add(&bfs->nextTail, *n, __ATOMIC_RELAXED);
+    memcpy(bfs->order + pos, local, *n * sizeof(int));
+    *n = 0;
+}
+
+void bfsTopDownStep(ParallelBFS* bfs) {
+    Graph* graph = bfs->graph;
+    int local[BFS_LOCAL_BUFFER];
+    int n = 0;
+    long examined = 0, outEdges = 0, inEdges = 0;
+    int frontierSize = bfs->tail - bfs->head;
+    int nextLevel = bfs->currentLevel + 1;
+    while (1) {
+        int start = __atomic_fetch_add(&bfs->nextChunk, BFS_CHUNK, __ATOMIC_RELAXED);
+        if (start >= frontierSize) break;
+        int end = start + BFS_CHUNK < frontierSize ? start + BFS_CHUNK : frontierSize;
+        for (int i = start; i < end; i++) {
+            int u = bfs->order[bfs->head + i];
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+                int w = graph->targets[e];
+                examined++;
+                if (claimVertex(bfs->visited, w)) {
+                    bfs->level[w] = nextLevel;
+                    outEdges += graph->offsets[w + 1] - graph->offsets[w];
+                    inEdges += graph->in_degree[w];
+                    local[n++] = w;
+                    if (n == BFS_LOCAL_BUFFER) bfsFlush(bfs, local, &n);
+                }
+            }
+        }
+    }
+    bfsFlush(bfs, local, &n);
+    __atomic_fetch_add(&bfs->edgesExamined, examined, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&bfs->frontierEdges, outEdges, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&bfs->exploredInEdges, inEdges, __ATOMIC_RELAXED);
+}
+
+void bfsBottomUpStep(ParallelBFS* bfs) {
+    Graph* graph = bfs->graph;
+    int local[BFS_LOCAL_BUFFER];
+    int n = 0;
+    long examined = 0, outEdges = 0, inEdges = 0;
+    int words = (graph->V + 63) / 64;
+    int nextLevel = bfs->currentLevel + 1;
+    while (1) {
+        int start = __atomic_fetch_add(&bfs->nextChunk, BFS_CHUNK, __ATOMIC_RELAXED);
+        if (start >= words) break;
+        int end = start + BFS_CHUNK < words ? start + BFS_CHUNK : words;
+        for (int word = start; word < end; word++) {
+            uint64_t unvisited = ~bfs->visited[word];
+            while (unvisited) {
+                int v = word * 64 + __builtin_ctzll(unvisited);
+                unvisited &= unvisited - 1;
+                if (v >= graph->V) break;
+                for (int e = graph->inOffsets[v]; e < graph->inOffsets[v + 1]; e++) {
+                    examined++;
+                    if (testBit(bfs->frontierBits, graph->sources[e])) {
+                        bfs->visited[word] |= (uint64_t)1 << (v & 63);
+                        bfs->level[v] = nextLevel;
+                        outEdges += graph->offsets[v + 1] - graph->offsets[v];
+                        inEdges += graph->in_degree[v];
+                        local[n++] = v;
+                        if (n == BFS_LOCAL_BUFFER) bfsFlush(bfs, local, &n);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    bfsFlush(bfs, local, &n);
+    __atomic_fetch_add(&bfs->edgesExamined, examined, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&bfs->frontierEdges, outEdges, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&bfs->exploredInEdges, inEdges, __ATOMIC_RELAXED);
+}
+
+void bfsStep(ParallelBFS* bfs) {
+    if (bfs->bottomUp) bfsBottomUpStep(bfs);
+    else bfsTopDownStep(bfs);
+}
+
+void* bfsWorker(void* arg) {
+    ParallelBFS* bfs = (ParallelBFS*)arg;
+    while (1) {
+        pthread_barrier_wait(&bfs->barrier);
+        if (bfs->done) break;
+        bfsStep(bfs);
+        pthread_barrier_wait(&bfs->barrier);
+    }
+    return NULL;
+}
+
+void bfs_create(ParallelBFS* bfs, Graph* graph, int threads, int allowBottomUp) {
+    ensureFrozen(graph);
+    if (allowBottomUp) ensureTransposed(graph);
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    int words = (graph->V + 63) / 64;
+    bfs->graph = graph;
+    bfs->threads = threads;
+    bfs->allowBottomUp = allowBottomUp;
+    bfs->visited = (uint64_t*)calloc(words, sizeof(uint64_t));
+    bfs->frontierBits = (uint64_t*)calloc(words, sizeof(uint64_t));
+    bfs->order = (int*)malloc(graph->V * sizeof(int));
+    bfs->level = (int*)malloc(graph->V * sizeof(int));
+    if (bfs->visited == NULL || bfs->frontierBits == NULL || bfs->order == NULL || bfs->level == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int v = 0; v < graph->V; v++)
+        bfs->level[v] = -1;
+    bfs->tail = 0;
+    bfs->bottomUpSteps = 0;
+    bfs->maxLevel = 0;
+    bfs->edgesExamined = 0;
+    bfs->unexploredEdges = graph->E;
+    bfs->done = 0;
+    pthread_barrier_init(&bfs->barrier, NULL, threads);
+    for (int t = 1; t < threads; t++)
+        pthread_create(&bfs->workers[t], NULL, bfsWorker, bfs);
+}
+
+void bfs_from(ParallelBFS* bfs, int root) {
+    Graph* graph = bfs->graph;
+    if (!claimVertex(bfs->visited, root)) return;
+    bfs->level[root] = 0;
+    bfs->head = bfs->tail;
+    bfs->order[bfs->tail++] = root;
+    bfs->currentLevel = 0;
+    bfs->bottomUp = 0;
+    bfs->frontierEdges = graph->offsets[root + 1] - graph->offsets[root];
+    bfs->unexploredEdges -= graph->in_degree[root];
+    int previousSize = 0;
+
+    while (bfs->head < bfs->tail) {
+        int frontierSize = bfs->tail - bfs->head;
+        if (bfs->allowBottomUp) {
+            if (!bfs->bottomUp && bfs->frontierEdges > bfs->unexploredEdges / BFS_ALPHA)
+                bfs->bottomUp = 1;
+            else if (bfs->bottomUp && frontierSize < previousSize && frontierSize < graph->V / BFS_BETA)
+                bfs->bottomUp = 0;
+        }
+        if (bfs->bottomUp) {
+            memset(bfs->frontierBits, 0, ((graph->V + 63) / 64) * sizeof(uint64_t));
+            for (int i = bfs->head; i < bfs->tail; i++)
+                bfs->frontierBits[bfs->order[i] >> 6] |= (uint64_t)1 << (bfs->order[i] & 63);
+            bfs->bottomUpSteps++;
+        }
+        bfs->nextTail = bfs->tail;
+        bfs->nextChunk = 0;
+        bfs->frontierEdges = 0;
+        bfs->exploredInEdges = 0;
+
+        pthread_barrier_wait(&bfs->barrier);
+        bfsStep(bfs);
+        pthread_barrier_wait(&bfs->barrier);
+
+        previousSize = frontierSize;
+        bfs->unexploredEdges -= bfs->exploredInEdges;
+        bfs->head = bfs->tail;
+        bfs->tail = bfs->nextTail;
+        bfs->currentLevel++;
+    }
+    if (bfs->currentLevel > bfs->maxLevel)
+        bfs->maxLevel = bfs->currentLevel;
+}
+
+void bfs_finish(ParallelBFS* bfs, BFSResult* result) {
+    bfs->done = 1;
+    pthread_barrier_wait(&bfs->barrier);
+    for (int t = 1; t < bfs->threads; t++)
+        pthread_join(bfs->workers[t], NULL);
+    pthread_barrier_destroy(&bfs->barrier);
+    result->order = bfs->order;
+    result->level = bfs->level;
+    result->count = bfs->tail;
+    result->levels = bfs->maxLevel;
+    result->bottomUpSteps = bfs->bottomUpSteps;
+    result->edgesExamined = bfs->edgesExamined;
+    free(bfs->visited);
+    free(bfs->frontierBits);
+}
+
+void parallelBFS(Graph* graph, int root, int threads, int allowBottomUp, BFSResult* result) {
+    ParallelBFS bfs;
+    bfs_create(&bfs, graph, threads, allowBottomUp);
+    if (root >= 0) {
+        bfs_from(&bfs, root);
+    } else {
+        for (int v = 0; v < graph->V; v++)
+            if (!testBit(bfs.visited, v))
+                bfs_from(&bfs, v);
+    }
+    bfs_finish(&bfs, result);
+}
+
+void bfsResult_free(BFSResult* result) {
+    free(result->order);
+    free(result->level);
+}
+
+void parallelBFT(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    printf("Enter source vertex (-1 to cover every vertex like BFT):\n");
+    int root = getInt();
+    if (root >= graph->V || root < -1) {
+        printf("!! Invalid vertex number.\n");
+        return;
+    }
+    if (root >= 0) root = lookupId(graph, root);
+    BFSResult result;
+    parallelBFS(graph, root, defaultThreadCount(), 1, &result);
+    printf("Parallel BFS (vertex:level): ");
+    for (int i = 0; i < result.count; i++)
+        printf("%d:%d ", displayId(graph, result.order[i]), result.level[result.order[i]]);
+    printf("\n-> %d vertices reached, %ld edges examined, %d bottom-up level(s).\n",
+           result.count, result.edgesExamined, result.bottomUpSteps);
+    bfsResult_free(&result);
+}
+
+#define KAHN_CHUNK 64
+#define KAHN_LOCAL_BUFFER 256
+
+typedef struct ParallelKahn {
+    Graph* graph;
+    int threads;
+    int* degree;
+    int* order;
+    int head;
+    int tail;
+    int nextTail;
+    int nextChunk;
+    int levels;
+    int done;
+    pthread_t workers[MAX_THREADS];
+    pthread_barrier_t barrier;
+} ParallelKahn;
+
+void kahnFlush(ParallelKahn* kahn, int* local, int* n) {
+    if (*n == 0) return;
+    int pos = __atomic_fetch_add(&kahn->nextTail, *n, __ATOMIC_RELAXED);
+    memcpy(kahn->order + pos, local, *n * sizeof(int));
+    *n = 0;
+}
+
+void kahnStep(ParallelKahn* kahn) {
+    Graph* graph = kahn->graph;
+    int local[KAHN_LOCAL_BUFFER];
+    int n = 0;
+    int frontierSize = kahn->tail - kahn->head;
+    while (1) {
+        int start = __atomic_fetch_add(&kahn->nextChunk, KAHN_CHUNK, __ATOMIC_RELAXED);
+        if (start >= frontierSize) break;
+        int end = start + KAHN_CHUNK < frontierSize ? start + KAHN_CHUNK : frontierSize;
+        for (int i = start; i < end; i++) {
+            int u = kahn->order[kahn->head + i];
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+                int w = graph->targets[e];
+                if (__atomic_sub_fetch(&kahn->degree[w], 1, __ATOMIC_RELAXED) == 0) {
+                    local[n++] = w;
+                    if (n == KAHN_LOCAL_BUFFER) kahnFlush(kahn, local, &n);
+                }
+            }
+        }
+    }
+    kahnFlush(kahn, local, &n);
+}
+
+void* kahnWorker(void* arg) {
+    ParallelKahn* kahn = (ParallelKahn*)arg;
+    while (1) {
+        pthread_barrier_wait(&kahn->barrier);
+        if (kahn->done) break;
+        kahnStep(kahn);
+        pthread_barrier_wait(&kahn->barrier);
+    }
+    return NULL;
+}
+
+int parallelKahn_order(Graph* graph, int threads, int* order, int* levels) {
+    ensureFrozen(graph);
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    ParallelKahn kahn;
+    kahn.graph = graph;
+    kahn.threads = threads;
+    kahn.order = order;
+    kahn.degree = (int*)malloc(graph->V * sizeof(int));
+    if (kahn.degree == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(kahn.degree, graph->in_degree, graph->V * sizeof(int));
+    kahn.head = kahn.tail = 0;
+    for (int i = 0; i < graph->V; i++)
+        if (kahn.degree[i] == 0)
+            order[kahn.tail++] = i;
+    kahn.levels = 0;
+    kahn.done = 0;
+
+    pthread_barrier_init(&kahn.barrier, NULL, threads);
+    for (int t = 1; t < threads; t++)
+        pthread_create(&kahn.workers[t], NULL, kahnWorker, &kahn);
+
+    while (kahn.head < kahn.tail) {
+        kahn.nextTail = kahn.tail;
+        kahn.nextChunk = 0;
+        pthread_barrier_wait(&kahn.barrier);
+        kahnStep(&kahn);
+        pthread_barrier_wait(&kahn.barrier);
+        kahn.head = kahn.tail;
+        kahn.tail = kahn.nextTail;
+        kahn.levels++;
+    }
+
+    kahn.done = 1;
+    pthread_barrier_wait(&kahn.barrier);
+    for (int t = 1; t < threads; t++)
+        pthread_join(kahn.workers[t], NULL);
+    pthread_barrier_destroy(&kahn.barrier);
+    free(kahn.degree);
+    if (levels != NULL) *levels = kahn.levels;
+    return kahn.tail;
+}
+
+int topologicalSort_KahnParallel(Graph* graph, int printSort) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return 0;
+    }
+    int* order = (int*)malloc((graph->V > 0 ? graph->V : 1) * sizeof(int));
+    if (order == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int levels;
+    int count = parallelKahn_order(graph, defaultThreadCount(), order, &levels);
+    if (count != graph->V) {
+        if (printSort) printf("!! Error: Graph contains a cycle. Topological sort not possible.\n");
+        free(order);
+        return 0;
+    }
+    if (printSort) {
+        printf("Topological Sort (Parallel Kahn's, %d levels): ", levels);
+        for (int i = 0; i < graph->V; i++)
+            printf("%d ", displayId(graph, order[i]));
+        printf("\n");
+    }
+    free(order);
+    return 1;
+}
+
+#define MSBFS_WORDS 4
+#define MSBFS_LANES (64 * MSBFS_WORDS)
+#define MSBFS_PRINT_LIMIT 30
+
+typedef struct MSBFSResult {
+    int sources;
+    int words;
+    int V;
+    uint64_t* seen;
+    int* reachCount;
+    int* dist;
+} MSBFSResult;
+
+int msbfs_reaches(MSBFSResult* result, int s, int v) {
+    return (result->seen[(size_t)v * result->words + (s >> 6)] >> (s & 63)) & 1;
+}
+
+void msbfs_batch(Graph* graph, int* sources, int first, int lanes, MSBFSResult* result,
+                 uint64_t* visit, uint64_t* next, int* frontier, int* nextFrontier) {
+    int V = graph->V;
+    int stride = result->words;
+    int column = first >> 6;
+    int laneWords = (lanes + 63) / 64;
+    int frontierSize = 0;
+    for (int lane = 0; lane < lanes; lane++) {
+        int s = sources[first + lane];
+        uint64_t bit = (uint64_t)1 << (lane & 63);
+        uint64_t* visitRow = visit + (size_t)s * MSBFS_WORDS;
+        int wasEmpty = 1;
+        for (int k = 0; k < laneWords; k++)
+            if (visitRow[k]) wasEmpty = 0;
+        if (wasEmpty) frontier[frontierSize++] = s;
+        visitRow[lane >> 6] |= bit;
+        result->seen[(size_t)s * stride + column + (lane >> 6)] |= bit;
+        result->reachCount[first + lane]++;
+        if (result->dist != NULL) result->dist[(size_t)(first + lane) * V + s] = 0;
+    }
+
+    int level = 0;
+    while (frontierSize > 0) {
+        int nextSize = 0;
+        level++;
+        for (int i = 0; i < frontierSize; i++) {
+            int v = frontier[i];
+            uint64_t* visitRow = visit + (size_t)v * MSBFS_WORDS;
+            for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+                int w = graph->targets[e];
+                uint64_t* seenRow = result->seen + (size_t)w * stride + column;
+                uint64_t* nextRow = next + (size_t)w * MSBFS_WORDS;
+                int wasEmpty = 1, added = 0;
+                for (int k = 0; k < laneWords; k++) {
+                    if (nextRow[k]) wasEmpty = 0;
+                    uint64_t fresh = visitRow[k] & ~seenRow[k];
+                    if (fresh == 0) continue;
+                    added = 1;
+                    nextRow[k] |= fresh;
+                    seenRow[k] |= fresh;
+                    while (fresh) {
+                        int lane = k * 64 + __builtin_ctzll(fresh);
+                        fresh &= fresh - 1;
+                        result->reachCount[first + lane]++;
+                        if (result->dist != NULL) result->dist[(size_t)(first + lane) * V + w] = level;
+                    }
+                }
+                if (added && wasEmpty) nextFrontier[nextSize++] = w;
+            }
+        }
+        for (int i = 0; i < frontierSize; i++)
+            memset(visit + (size_t)frontier[i] * MSBFS_WORDS, 0, laneWords * sizeof(uint64_t));
+        uint64_t* t = visit; visit = next; next = t;
+        int* f = frontier; frontier = nextFrontier; nextFrontier = f;
+        frontierSize = nextSize;
+    }
+}
+
+void msbfs_run(Graph* graph, int* sources, int nSources, int wantDistances, MSBFSResult* result) {
+    ensureFrozen(graph);
+    int V = graph->V;
+    result->sources = nSources;
+    result->words = (nSources + 63) / 64;
+    result->V = V;
+    result->seen = (uint64_t*)calloc((size_t)V * result->words, sizeof(uint64_t));
+    result->reachCount = (int*)calloc(nSources, sizeof(int));
+    result->dist = NULL;
+    if (wantDistances) {
+        result->dist = (int*)malloc((size_t)nSources * V * sizeof(int));
+        if (result->dist != NULL)
+            for (size_t i = 0; i < (size_t)nSources * V; i++)
+                result->dist[i] = -1;
+    }
+    uint64_t* visit = (uint64_t*)calloc((size_t)V * MSBFS_WORDS, sizeof(uint64_t));
+    uint64_t* next = (uint64_t*)calloc((size_t)V * MSBFS_WORDS, sizeof(uint64_t));
+    int* frontier = (int*)malloc(V * sizeof(int));
+    int* nextFrontier = (int*)malloc(V * sizeof(int));
+    if (result->seen == NULL || result->reachCount == NULL || (wantDistances && result->dist == NULL) ||
+        visit == NULL || next == NULL || frontier == NULL || nextFrontier == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+
+    for (int first = 0; first < nSources; first += MSBFS_LANES) {
+        int lanes = nSources - first < MSBFS_LANES ? nSources - first : MSBFS_LANES;
+        msbfs_batch(graph, sources, first, lanes, result, visit, next, frontier, nextFrontier);
+    }
+
+    free(visit);
+    free(next);
+    free(frontier);
+    free(nextFrontier);
+}
+
+void msbfs_free(MSBFSResult* result) {
+    free(result->seen);
+    free(result->reachCount);
+    free(result->dist);
+}
+
+void batchReachability(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    printf("Enter source vertices one per line (-1 to finish):\n");
+    int* sources = (int*)malloc((graph->V > 0 ? graph->V : 1) * sizeof(int));
+    if (sources == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int n = 0;
+    while (n < graph->V) {
+        int s = getInt();
+        if (s == -1) break;
+        if (s < 0 || s >= graph->V) {
+            printf("!! Invalid vertex number.\n");
+            continue;
+        }
+        sources[n++] = lookupId(graph, s);
+    }
+    if (n == 0) {
+        free(sources);
+        return;
+    }
+    MSBFSResult result;
+    msbfs_run(graph, sources, n, 1, &result);
+    printf("\n--- Batch Reachability (multi-source BFS, %d sources) ---\n", n);
+    for (int i = 0; i < n; i++) {
+        printf("From %d (%d reachable): ", displayId(graph, sources[i]), result.reachCount[i] - 1);
+        int shown = 0;
+        for (int v = 0; v < graph->V && shown < MSBFS_PRINT_LIMIT; v++)
+            if (v != sources[i] && msbfs_reaches(&result, i, v)) {
+                printf("%d(d=%d) ", displayId(graph, v), result.dist[(size_t)i * graph->V + v]);
+                shown++;
+            }
+        if (result.reachCount[i] - 1 > shown) printf("...");
+        printf("\n");
+    }
+    msbfs_free(&result);
+    free(sources);
+}
+
+#define EDGE_BINARY_MAGIC "EDGEBIN1"
+
+typedef struct EdgeBinaryHeader {
+    char magic[8];
+    int32_t vertices;
+    int32_t reserved;
+    int64_t edges;
+} EdgeBinaryHeader;
+
+typedef struct LoadStats {
+    double seconds;
+    long badLines;
+    int threads;
+    int binary;
+    size_t fileSize;
+} LoadStats;
+
+long peakResidentKB() {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f == NULL) return -1;
+    char line[256];
+    long kb = -1;
+    while (fgets(line, sizeof(line), f) != NULL)
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = atol(line + 6);
+            break;
+        }
+    fclose(f);
+    return kb;
+}
+
+void resetPeakResident() {
+    FILE* f = fopen("/proc/self/clear_refs", "w");
+    if (f == NULL) return;
+    fputs("5", f);
+    fclose(f);
+}
+
+Graph* graphFromEdges(int V, int* src, int* dest, int E) {
+    Graph* graph = createGraph(V);
+    free(graph->edgeSrc);
+    free(graph->edgeDest);
+    graph->edgeSrc = src;
+    graph->edgeDest = dest;
+    graph->E = E;
+    graph->edgeCapacity = E > 0 ? E : 1;
+    for (int e = 0; e < E; e++)
+        graph->in_degree[dest[e]]++;
+    freezeGraph(graph);
+    return graph;
+}
+
+const char* parseUInt(const char* p, const char* end, long* value) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) p++;
+    if (p == end || *p < '0' || *p > '9') return NULL;
+    long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        if (v >= 0x7FFFFFFF) return NULL;   // ID + 1 must still fit in an int vertex count
+        p++;
+    }
+    *value = v;
+    return p;
+}
+
+#define LOADER_RELEASE_BYTES (16L << 20)
+#define LOADER_VERTEX_SLACK 1024
+
+// Each edge names at most two vertices, so a vertex count far beyond the edge
+// count comes from a stray ID (or a bad header) and would only waste memory
+int loaderVertexCountOk(long V, long E) {
+    if (V <= 4 * E + LOADER_VERTEX_SLACK)
+        return 1;
+    printf("!! %ld vertices for only %ld edges; refusing to allocate them (stray vertex ID?).\n", V, E);
+    return 0;
+}
+
+const char* releaseParsed(const char* from, const char* to) {
+    long page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t)from + page - 1) & ~(uintptr_t)(page - 1);
+    uintptr_t stop = (uintptr_t)to & ~(uintptr_t)(page - 1);
+    if (stop > start)
+        madvise((void*)start, stop - start, MADV_DONTNEED);
+    return to;
+}
+
+typedef struct TextChunk {
+    const char* begin;
+    const char* end;
+    int* src;
+    int* dest;
+    long capacity;
+    long count;
+    long bad;
+    int maxVertex;
+} TextChunk;
+
+const char* alignToLine(const char* p, const char* base, const char* end) {
+    if (p == base) return p;
+    const char* nl = (const char*)memchr(p - 1, '\n', end - (p - 1));
+    return nl == NULL ? end : nl + 1;
+}
+
+long countLines(const char* begin, const char* end) {
+    long lines = 0;
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        lines++;
+        if (nl == NULL) break;
+        p = nl + 1;
+    }
+    return lines;
+}
+
+void* parseTextChunk(void* arg) {
+    TextChunk* chunk = (TextChunk*)arg;
+    const char* p = chunk->begin;
+    const char* end = chunk->end;
+    const char* released = p;
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+        if (lineEnd == NULL) lineEnd = end;
+        const char* q = p;
+        while (q < lineEnd && (*q == ' ' || *q == '\t' || *q == '\r')) q++;
+        if (q < lineEnd && *q != '#' && *q != '%') {
+            long a, b;
+            q = parseUInt(q, lineEnd, &a);
+            if (q != NULL) q = parseUInt(q, lineEnd, &b);
+            if (q != NULL && chunk->count < chunk->capacity) {
+                chunk->src[chunk->count] = (int)a;
+                chunk->dest[chunk->count] = (int)b;
+                chunk->count++;
+                if (a > chunk->maxVertex) chunk->maxVertex = (int)a;
+                if (b > chunk->maxVertex) chunk->maxVertex = (int)b;
+            } else {
+                chunk->bad++;
+            }
+        }
+        p = lineEnd + 1;
+        if (p - released >= LOADER_RELEASE_BYTES)
+            released = releaseParsed(released, p < end ? p : end);
+    }
+    releaseParsed(released, end);
+    return NULL;
+}
+
+Graph* loadTextEdges(const char* data, size_t size, int threads, LoadStats* stats) {
+    const char* end = data + size;
+    TextChunk chunks[MAX_THREADS];
+    pthread_t workers[MAX_THREADS];
+    const char* cut = data;
+    long total = 0;
+    for (int t = 0; t < threads; t++) {
+        chunks[t].begin = cut;
+        cut = t == threads - 1 ? end : alignToLine(data + size / threads * (t + 1), data, end);
+        if (cut < chunks[t].begin) cut = chunks[t].begin;
+        chunks[t].end = cut;
+        chunks[t].capacity = countLines(chunks[t].begin, chunks[t].end);
+        chunks[t].count = 0;
+        chunks[t].bad = 0;
+        chunks[t].maxVertex = -1;
+        total += chunks[t].capacity;
+    }
+    if (total > 0x7FFFFFFF) {
+        printf("!! Edge list too large (more than 2^31 lines).\n");
+        return NULL;
+    }
+    int* src = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    int* dest = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    if (src == NULL || dest == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    long offset = 0;
+    for (int t = 0; t < threads; t++) {
+        chunks[t].src = src + offset;
+        chunks[t].dest = dest + offset;
+        offset += chunks[t].capacity;
+    }
+    for (int t = 1; t < threads; t++)
+        pthread_create(&workers[t], NULL, parseTextChunk, &chunks[t]);
+    parseTextChunk(&chunks[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(workers[t], NULL);
+
+    long E = 0;
+    int maxVertex = -1;
+    for (int t = 0; t < threads; t++) {
+        if (chunks[t].src != src + E) {
+            memmove(src + E, chunks[t].src, chunks[t].count * sizeof(int));
+            memmove(dest + E, chunks[t].dest, chunks[t].count * sizeof(int));
+        }
+        E += chunks[t].count;
+        stats->badLines += chunks[t].bad;
+        if (chunks[t].maxVertex > maxVertex) maxVertex = chunks[t].maxVertex;
+    }
+    if (maxVertex < 0) {
+        free(src);
+        free(dest);
+        printf("!! No edges found in file.\n");
+        return NULL;
+    }
+    if (!loaderVertexCountOk((long)maxVertex + 1, E)) {
+        free(src);
+        free(dest);
+        return NULL;
+    }
+    return graphFromEdges(maxVertex + 1, src, dest, (int)E);
+}
+
+typedef struct BinaryChunk {
+    const int32_t* pairs;
+    long first;
+    long last;
+    int* src;
+    int* dest;
+    int V;
+    long bad;
+} BinaryChunk;
+
+void* copyBinaryChunk(void* arg) {
+    BinaryChunk* chunk = (BinaryChunk*)arg;
+    const char* released = (const char*)(chunk->pairs + 2 * chunk->first);
+    for (long e = chunk->first; e < chunk->last; e++) {
+        if ((e & 0xFFFFF) == 0)
+            released = releaseParsed(released, (const char*)(chunk->pairs + 2 * e));
+        int a = chunk->pairs[2 * e], b = chunk->pairs[2 * e + 1];
+        if (a < 0 || b < 0 || a >= chunk->V || b >= chunk->V) {
+            chunk->bad++;
+            continue;
+        }
+        chunk->src[e] = a;
+        chunk->dest[e] = b;
+    }
+    releaseParsed(released, (const char*)(chunk->pairs + 2 * chunk->last));
+    return NULL;
+}
+
+Graph* loadBinaryEdges(const char* data, size_t size, int threads, LoadStats* stats) {
+    EdgeBinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.vertices <= 0 || header.edges < 0 || header.edges > 0x7FFFFFFF ||
+        sizeof(header) + (size_t)header.edges * 2 * sizeof(int32_t) > size) {
+        printf("!! Corrupt binary edge list header.\n");
+        return NULL;
+    }
+    if (!loaderVertexCountOk(header.vertices, header.edges))
+        return NULL;
+    long E = header.edges;
+    int* src = (int*)malloc((E > 0 ? E : 1) * sizeof(int));
+    int* dest = (int*)malloc((E > 0 ? E : 1) * sizeof(int));
+    if (src == NULL || dest == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    BinaryChunk chunks[MAX_THREADS];
+    pthread_t workers[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        chunks[t].pairs = (const int32_t*)(data + sizeof(header));
+        chunks[t].first = E * t / threads;
+        chunks[t].last = E * (t + 1) / threads;
+        chunks[t].src = src;
+        chunks[t].dest = dest;
+        chunks[t].V = header.vertices;
+        chunks[t].bad = 0;
+    }
+    for (int t = 1; t < threads; t++)
+        pthread_create(&workers[t], NULL, copyBinaryChunk, &chunks[t]);
+    copyBinaryChunk(&chunks[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(workers[t], NULL);
+    for (int t = 0; t < threads; t++)
+        stats->badLines += chunks[t].bad;
+    if (stats->badLines > 0) {
+        printf("!! %ld edges reference vertices outside 0..%d. File rejected.\n",
+               stats->badLines, header.vertices - 1);
+        free(src);
+        free(dest);
+        return NULL;
+    }
+    return graphFromEdges(header.vertices, src, dest, (int)E);
+}
+
+Graph* loadEdgeListFile(const char* path, int threads, LoadStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    stats->threads = threads;
+    double t0 = nowSeconds();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("!! Could not open '%s'.\n", path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        printf("!! '%s' is empty or unreadable.\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    char* data = (char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("!! mmap failed for '%s'.\n", path);
+        return NULL;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    stats->fileSize = size;
+    stats->binary = size >= sizeof(EdgeBinaryHeader) && memcmp(data, EDGE_BINARY_MAGIC, 8) == 0;
+    Graph* graph = stats->binary ? loadBinaryEdges(data, size, threads, stats)
+                                 : loadTextEdges(data, size, threads, stats);
+    munmap(data, size);
+    stats->seconds = nowSeconds() - t0;
+    return graph;
+}
+
+int saveEdgeListFile(Graph* graph, const char* path, int binary) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        printf("!! Could not create '%s'.\n", path);
+        return 0;
+    }
+    static char buffer[1 << 20];
+    setvbuf(f, buffer, _IOFBF, sizeof(buffer));
+    if (binary) {
+        EdgeBinaryHeader header;
+        memcpy(header.magic, EDGE_BINARY_MAGIC, 8);
+        header.vertices = graph->V;
+        header.reserved = 0;
+        header.edges = graph->E;
+        fwrite(&header, sizeof(header), 1, f);
+        for (int e = 0; e < graph->E; e++) {
+            int32_t pair[2] = { displayId(graph, graph->edgeSrc[e]), displayId(graph, graph->edgeDest[e]) };
+            fwrite(pair, sizeof(pair), 1, f);
+        }
+    } else {
+        fprintf(f, "# %d vertices, %d edges\n", graph->V, graph->E);
+        for (int e = 0; e < graph->E; e++)
+            fprintf(f, "%d %d\n", displayId(graph, graph->edgeSrc[e]), displayId(graph, graph->edgeDest[e]));
+    }
+    int ok = fclose(f) == 0;
+    if (!ok) printf("!! Write error on '%s'.\n", path);
+    return ok;
+}
+
+Graph* loadGraphMenu(Graph* oldGraph) {
+    char path[512];
+    printf("Edge-list file path (text 'src dest' lines or %s binary):\n> ", EDGE_BINARY_MAGIC);
+    if (scanf("%511s", path) != 1) {
+        clearInputBuffer();
+        return oldGraph;
+    }
+    clearInputBuffer();
+    LoadStats stats;
+    resetPeakResident();
+    Graph* graph = loadEdgeListFile(path, defaultThreadCount(), &stats);
+    if (graph == NULL) return oldGraph;
+    freeGraph(oldGraph);
+    printf("-> Loaded %d vertices, %d edges from %s file (%.1f MB) in %.3f s with %d thread(s).\n",
+           graph->V, graph->E, stats.binary ? "binary" : "text", stats.fileSize / (1024.0 * 1024.0),
+           stats.seconds, stats.threads);
+    printf("-> %.2f M edges/s, peak RSS %.1f MB, %ld malformed line(s) skipped.\n",
+           graph->E / stats.seconds / 1e6, peakResidentKB() / 1024.0, stats.badLines);
+    return graph;
+}
+
+void saveGraphMenu(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    char path[512];
+    printf("Output file path:\n> ");
+    if (scanf("%511s", path) != 1) {
+        clearInputBuffer();
+        return;
+    }
+    clearInputBuffer();
+    printf("Format: 1. Text  2. Binary\n");
+    int binary = getInt() == 2;
+    double t0 = nowSeconds();
+    if (saveEdgeListFile(graph, path, binary))
+        printf("-> Wrote %d edges to '%s' in %.3f s.\n", graph->E, path, nowSeconds() - t0);
+}
+
+enum { REORDER_NONE, REORDER_BFS, REORDER_RCM, REORDER_DEGREE };
+
+const char* reorderNames[] = { "As loaded", "BFS order", "Reverse Cuthill-McKee", "Degree-sorted" };
+
+int compareKeys(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+int* totalDegrees(Graph* graph, int* maxDegree) {
+    ensureFrozen(graph);
+    int* degree = (int*)malloc(graph->V * sizeof(int));
+    if (degree == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    *maxDegree = 0;
+    for (int v = 0; v < graph->V; v++) {
+        degree[v] = graph->offsets[v + 1] - graph->offsets[v] + graph->in_degree[v];
+        if (degree[v] > *maxDegree) *maxDegree = degree[v];
+    }
+    return degree;
+}
+
+void degree_order(Graph* graph, int* order, int descending) {
+    int maxDegree;
+    int* degree = totalDegrees(graph, &maxDegree);
+    int* count = (int*)calloc(maxDegree + 2, sizeof(int));
+    if (count == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int v = 0; v < graph->V; v++)
+        count[(descending ? maxDegree - degree[v] : degree[v]) + 1]++;
+    for (int d = 0; d <= maxDegree; d++)
+        count[d + 1] += count[d];
+    for (int v = 0; v < graph->V; v++)
+        order[count[descending ? maxDegree - degree[v] : degree[v]]++] = v;
+    free(count);
+    free(degree);
+}
+
+void rcm_order(Graph* graph, int* order) {
+    ensureTransposed(graph);
+    int V = graph->V;
+    int maxDegree;
+    int* degree = totalDegrees(graph, &maxDegree);
+    int* starts = (int*)malloc(V * sizeof(int));
+    char* visited = (char*)calloc(V, 1);
+    uint64_t* keys = (uint64_t*)malloc(V * sizeof(uint64_t));
+    if (starts == NULL || visited == NULL || keys == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    degree_order(graph, starts, 0);
+
+    int head = 0, tail = 0;
+    for (int i = 0; i < V; i++) {
+        int s = starts[i];
+        if (visited[s]) continue;
+        visited[s] = 1;
+        order[tail++] = s;
+        while (head < tail) {
+            int u = order[head++];
+            int first = tail;
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+                int w = graph->targets[e];
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    order[tail++] = w;
+                }
+            }
+            for (int e = graph->inOffsets[u]; e < graph->inOffsets[u + 1]; e++) {
+                int w = graph->sources[e];
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    order[tail++] = w;
+                }
+            }
+            if (tail - first > 1) {
+                for (int k = first; k < tail; k++)
+                    keys[k - first] = (uint64_t)degree[order[k]] << 32 | (uint32_t)order[k];
+                qsort(keys, tail - first, sizeof(uint64_t), compareKeys);
+                for (int k = first; k < tail; k++)
+                    order[k] = (int)(uint32_t)keys[k - first];
+            }
+        }
+    }
+    for (int i = 0, j = V - 1; i < j; i++, j--) {
+        int t = order[i]; order[i] = order[j]; order[j] = t;
+    }
+    free(keys);
+    free(visited);
+    free(starts);
+    free(degree);
+}
+
+void reorder_order(Graph* graph, int method, int* order) {
+    if (method == REORDER_BFS) {
+        BFT_order(graph, order);
+    } else if (method == REORDER_RCM) {
+        rcm_order(graph, order);
+    } else if (method == REORDER_DEGREE) {
+        degree_order(graph, order, 1);
+    } else {
+        for (int v = 0; v < graph->V; v++)
+            order[v] = v;
+    }
+}
+
+Graph* relabelGraph(Graph* graph, const int* order) {
+    int V = graph->V, E = graph->E;
+    int* newId = (int*)malloc(V * sizeof(int));
+    int* src = (int*)malloc((E > 0 ? E : 1) * sizeof(int));
+    int* dest = (int*)malloc((E > 0 ? E : 1) * sizeof(int));
+    if (newId == NULL || src == NULL || dest == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int i = 0; i < V; i++)
+        newId[order[i]] = i;
+    for (int e = 0; e < E; e++) {
+        src[e] = newId[graph->edgeSrc[e]];
+        dest[e] = newId[graph->edgeDest[e]];
+    }
+    Graph* result = graphFromEdges(V, src, dest, E);
+
+    ensureTransposed(result);
+    int* cursor = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (cursor == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(cursor, result->offsets, V * sizeof(int));
+    for (int w = 0; w < V; w++)
+        for (int e = result->inOffsets[w]; e < result->inOffsets[w + 1]; e++)
+            result->targets[cursor[result->sources[e]]++] = w;
+    free(cursor);
+
+    result->originalId = (int*)malloc(V * sizeof(int));
+    result->internalId = (int*)malloc(V * sizeof(int));
+    if (result->originalId == NULL || result->internalId == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int v = 0; v < V; v++) {
+        int id = displayId(graph, v);
+        result->originalId[newId[v]] = id;
+        result->internalId[id] = newId[v];
+    }
+    free(newId);
+    return result;
+}
+
+double averageEdgeSpan(Graph* graph) {
+    if (graph->E == 0) return 0.0;
+    double total = 0.0;
+    for (int e = 0; e < graph->E; e++)
+        total += abs(graph->edgeSrc[e] - graph->edgeDest[e]);
+    return total / graph->E;
+}
+
+Graph* reorderGraphMenu(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return NULL;
+    }
+    printf("\n-- Vertex Reordering Menu --\n");
+    printf("1. BFS order\n");
+    printf("2. Reverse Cuthill-McKee (RCM)\n");
+    printf("3. Degree-sorted (hubs first)\n");
+    int method = getInt();
+    if (method < REORDER_BFS || method > REORDER_DEGREE) {
+        printf("!! Invalid choice.\n");
+        return graph;
+    }
+    double spanBefore = averageEdgeSpan(graph);
+    double t0 = nowSeconds();
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    reorder_order(graph, method, order);
+    Graph* result = relabelGraph(graph, order);
+    double elapsed = nowSeconds() - t0;
+    free(order);
+    if (graph->online != NULL)
+        printf("-> Online ordering was switched off; enable it again from the menu if needed.\n");
+    freeGraph(graph);
+    printf("-> %s applied to %d vertices in %.3f ms. Average edge span %.1f -> %.1f.\n",
+           reorderNames[method], result->V, elapsed * 1e3, spanBefore, averageEdgeSpan(result));
+    printf("-> Vertex numbers are still shown and entered as originally labelled.\n");
+    return result;
+}
+
+typedef struct CompressedGraph {
+    int V;
+    int E;
+    long bytes;
+    long* offsets;
+    unsigned char* data;
+    int* in_degree;
+} CompressedGraph;
+
+typedef struct NeighborCursor {
+    const unsigned char* p;
+    const unsigned char* end;
+    int last;
+    int first;
+} NeighborCursor;
+
+unsigned char* writeVarint(unsigned char* p, unsigned x) {
+    while (x >= 0x80) {
+        *p++ = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    *p++ = (unsigned char)x;
+    return p;
+}
+
+unsigned readVarint(const unsigned char** p) {
+    const unsigned char* q = *p;
+    unsigned x = *q++;
+    if (x >= 0x80) {
+        x &= 0x7F;
+        int shift = 7;
+        unsigned char b;
+        do {
+            b = *q++;
+            x |= (unsigned)(b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+    }
+    *p = q;
+    return x;
+}
+
+CompressedGraph* compressGraph(Graph* graph) {
+    ensureFrozen(graph);
+    int V = graph->V;
+    CompressedGraph* cg = (CompressedGraph*)malloc(sizeof(CompressedGraph));
+    long capacity = (long)graph->E + V + 16;
+    cg->V = V;
+    cg->E = graph->E;
+    cg->offsets = (long*)malloc((V + 1) * sizeof(long));
+    cg->data = (unsigned char*)malloc(capacity);
+    cg->in_degree = (int*)malloc(V * sizeof(int));
+    int maxDegree = 0;
+    for (int v = 0; v < V; v++)
+        if (graph->offsets[v + 1] - graph->offsets[v] > maxDegree)
+            maxDegree = graph->offsets[v + 1] - graph->offsets[v];
+    int* scratch = (int*)malloc((maxDegree > 0 ? maxDegree : 1) * sizeof(int));
+    if (cg->offsets == NULL || cg->data == NULL || cg->in_degree == NULL || scratch == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(cg->in_degree, graph->in_degree, V * sizeof(int));
+
+    long used = 0;
+    for (int v = 0; v < V; v++) {
+        cg->offsets[v] = used;
+        int degree = graph->offsets[v + 1] - graph->offsets[v];
+        if (degree == 0) continue;
+        memcpy(scratch, graph->targets + graph->offsets[v], degree * sizeof(int));
+        int sorted = 1;
+        for (int i = 1; i < degree && sorted; i++)
+            sorted = scratch[i - 1] <= scratch[i];
+        if (!sorted) qsort(scratch, degree, sizeof(int), compareInts);
+        if (used + 5L * degree > capacity) {
+            while (used + 5L * degree > capacity) capacity *= 2;
+            cg->data = (unsigned char*)realloc(cg->data, capacity);
+            if (cg->data == NULL) {
+                printf("!! Fatal Error: Memory allocation failed.\n");
+                exit(1);
+            }
+        }
+        unsigned char* p = cg->data + used;
+        int delta = scratch[0] - v;
+        p = writeVarint(p, ((unsigned)delta << 1) ^ (unsigned)(delta >> 31));
+        for (int i = 1; i < degree; i++)
+            p = writeVarint(p, (unsigned)(scratch[i] - scratch[i - 1]));
+        used = p - cg->data;
+    }
+    cg->offsets[V] = used;
+    cg->bytes = used;
+    cg->data = (unsigned char*)realloc(cg->data, used > 0 ? used : 1);
+    free(scratch);
+    return cg;
+}
+
+void cg_open(CompressedGraph* cg, int v, NeighborCursor* c) {
+    c->p = cg->data + cg->offsets[v];
+    c->end = cg->data + cg->offsets[v + 1];
+    c->last = v;
+    c->first = 1;
+}
+
+int cg_next(NeighborCursor* c, int* w) {
+    if (c->p == c->end) return 0;
+    unsigned x = readVarint(&c->p);
+    if (c->first) {
+        c->last += (int)(x >> 1) ^ -(int)(x & 1);
+        c->first = 0;
+    } else {
+        c->last += (int)x;
+    }
+    *w = c->last;
+    return 1;
+}
+
+size_t cg_memoryBytes(CompressedGraph* cg) {
+    return cg->bytes + (cg->V + 1) * sizeof(long);
+}
+
+void cg_free(CompressedGraph* cg) {
+    if (cg == NULL) return;
+    free(cg->offsets);
+    free(cg->data);
+    free(cg->in_degree);
+    free(cg);
+}
+
+int cg_BFT_order(CompressedGraph* cg, int* order) {
+    char* visited = (char*)calloc(cg->V, 1);
+    if (visited == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int head = 0, tail = 0;
+    for (int i = 0; i < cg->V; i++) {
+        if (visited[i]) continue;
+        visited[i] = 1;
+        order[tail++] = i;
+        while (head < tail) {
+            NeighborCursor c;
+            cg_open(cg, order[head++], &c);
+            int w;
+            while (cg_next(&c, &w))
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    order[tail++] = w;
+                }
+        }
+    }
+    free(visited);
+    return tail;
+}
+
+int cg_DFT_order(CompressedGraph* cg, int* order) {
+    char* visited = (char*)calloc(cg->V, 1);
+    NeighborCursor* stack = (NeighborCursor*)malloc(cg->V * sizeof(NeighborCursor));
+    if (visited == NULL || stack == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int count = 0;
+    for (int i = 0; i < cg->V; i++) {
+        if (visited[i]) continue;
+        visited[i] = 1;
+        order[count++] = i;
+        int top = 0;
+        cg_open(cg, i, &stack[0]);
+        while (top >= 0) {
+            int w;
+            if (!cg_next(&stack[top], &w)) {
+                top--;
+                continue;
+            }
+            if (!visited[w]) {
+                visited[w] = 1;
+                order[count++] = w;
+                cg_open(cg, w, &stack[++top]);
+            }
+        }
+    }
+    free(stack);
+    free(visited);
+    return count;
+}
+
+int cg_kahn_order(CompressedGraph* cg, int* order) {
+    int* in_degree_copy = (int*)malloc(cg->V * sizeof(int));
+    if (in_degree_copy == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(in_degree_copy, cg->in_degree, cg->V * sizeof(int));
+    int head = 0, tail = 0;
+    for (int i = 0; i < cg->V; i++)
+        if (in_degree_copy[i] == 0)
+            order[tail++] = i;
+    while (head < tail) {
+        NeighborCursor c;
+        cg_open(cg, order[head++], &c);
+        int w;
+        while (cg_next(&c, &w))
+            if (--in_degree_copy[w] == 0)
+                order[tail++] = w;
+    }
+    free(in_degree_copy);
+    return tail;
+}
+
+void compressedTraversals(Graph* graph) {
+    if (graph == NULL) {
+        printf("!! Graph not created yet.\n");
+        return;
+    }
+    double t0 = nowSeconds();
+    CompressedGraph* cg = compressGraph(graph);
+    double elapsed = nowSeconds() - t0;
+    double perEdge = cg->E > 0 ? (double)cg_memoryBytes(cg) / cg->E : 0.0;
+    double csrPerEdge = cg->E > 0 ? (double)(graph->E + graph->V + 1) * sizeof(int) / cg->E : 0.0;
+    printf("\n--- Compressed Adjacency (sorted, delta + varint) ---\n");
+    printf("-> %d edges in %ld bytes of neighbour data; %.2f bytes/edge with offsets (CSR %.2f), built in %.3f ms.\n",
+           cg->E, cg->bytes, perEdge, csrPerEdge, elapsed * 1e3);
+
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    int count = cg_BFT_order(cg, order);
+    printOrder(graph, "Breadth First Traversal", order, count);
+    count = cg_DFT_order(cg, order);
+    printOrder(graph, "Depth First Traversal", order, count);
+    count = cg_kahn_order(cg, order);
+    if (count != graph->V) printf("!! Error: Graph contains a cycle. Topological sort not possible.\n");
+    else printOrder(graph, "Topological Sort (Kahn's)", order, count);
+    free(order);
+    cg_free(cg);
+}
+
+unsigned nextRandom(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+Graph* generateRandomDAG(int V, int E, unsigned seed) {
+    Graph* graph = createGraph(V);
+    unsigned state = seed ? seed : 1;
+    for (int i = 0; i < E; i++) {
+        int a = nextRandom(&state) % V;
+        int b = nextRandom(&state) % V;
+        if (a == b) b = (a + 1) % V;
+        if (a > b) { int t = a; a = b; b = t; }
+        appendEdge(graph, a, b);
+    }
+    return graph;
+}
+
+AdjListNode** buildLinkedAdjacency(Graph* graph) {
+    AdjListNode** adj = (AdjListNode**)calloc(graph->V, sizeof(AdjListNode*));
+    for (int e = 0; e < graph->E; e++) {
+        AdjListNode* node = (AdjListNode*)malloc(sizeof(AdjListNode));
+        if (node == NULL) {
+            printf("!! Fatal Error: Memory allocation failed.\n");
+            exit(1);
+        }
+        node->dest = graph->edgeDest[e];
+        node->next = adj[graph->edgeSrc[e]];
+        adj[graph->edgeSrc[e]] = node;
+    }
+    return adj;
+}
+
+void freeLinkedAdjacency(AdjListNode** adj, int V) {
+    for (int v = 0; v < V; v++) {
+        AdjListNode* node = adj[v];
+        while (node != NULL) {
+            AdjListNode* next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(adj);
+}
+
+int linkedBFT_order(AdjListNode** adj, int V, int* order) {
+    int* visited = (int*)calloc(V, sizeof(int));
+    Queue* q = createQueue();
+    int count = 0;
+    for (int i = 0; i < V; i++) {
+        if (!visited[i]) {
+            visited[i] = 1;
+            enqueue(q, i);
+            while (!isQueueEmpty(q)) {
+                int v = dequeue(q);
+                order[count++] = v;
+                for (AdjListNode* node = adj[v]; node != NULL; node = node->next)
+                    if (!visited[node->dest]) {
+                        visited[node->dest] = 1;
+                        enqueue(q, node->dest);
+                    }
+            }
+        }
+    }
+    free(visited);
+    free(q);
+    return count;
+}
+
+int linkedKahn(AdjListNode** adj, int V, int* in_degree) {
+    int* degree = (int*)malloc(V * sizeof(int));
+    memcpy(degree, in_degree, V * sizeof(int));
+    Queue* q = createQueue();
+    for (int i = 0; i < V; i++)
+        if (degree[i] == 0)
+            enqueue(q, i);
+    int count = 0;
+    while (!isQueueEmpty(q)) {
+        int u = dequeue(q);
+        count++;
+        for (AdjListNode* node = adj[u]; node != NULL; node = node->next)
+            if (--degree[node->dest] == 0)
+                enqueue(q, node->dest);
+    }
+    free(degree);
+    free(q);
+    return count == V;
+}
+
+void csrBenchmark() {
+    printf("\n--- CSR vs Linked Adjacency Benchmark (random DAG) ---\n");
+    printf("Number of vertices (e.g. 1000000):\n");
+    int V = getInt();
+    printf("Number of edges (e.g. 10000000):\n");
+    int E = getInt();
+    if (V < 2 || E < 0) {
+        printf("!! Need at least 2 vertices and a non-negative edge count.\n");
+        return;
+    }
+
+    double t0 = nowSeconds();
+    Graph* graph = generateRandomDAG(V, E, 12345);
+    double tCollect = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    AdjListNode** adj = buildLinkedAdjacency(graph);
+    double tLinkedBuild = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    freezeGraph(graph);
+    double tFreeze = nowSeconds() - t0;
+
+    int* order = (int*)malloc(V * sizeof(int));
+    int* orderLinked = (int*)malloc(V * sizeof(int));
+
+    t0 = nowSeconds();
+    int countLinked = linkedBFT_order(adj, V, orderLinked);
+    double tLinkedBFT = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    int count = BFT_order(graph, order);
+    double tBFT = nowSeconds() - t0;
+
+    int same = (count == countLinked) && memcmp(order, orderLinked, count * sizeof(int)) == 0;
+
+    t0 = nowSeconds();
+    int dagLinked = linkedKahn(adj, V, graph->in_degree);
+    double tLinkedKahn = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    int dag = topologicalSort_Kahn(graph, 0);
+    double tKahn = nowSeconds() - t0;
+
+    printf("\nGraph: %d vertices, %d edges (edge list collected in %.3f s)\n", V, graph->E, tCollect);
+    printf("%-22s %12s %12s %9s\n", "Phase", "Linked (s)", "CSR (s)", "Speedup");
+    printf("%-22s %12.3f %12.3f %8.2fx\n", "Build adjacency", tLinkedBuild, tFreeze, tLinkedBuild / tFreeze);
+    printf("%-22s %12.3f %12.3f %8.2fx\n", "BFT", tLinkedBFT, tBFT, tLinkedBFT / tBFT);
+    printf("%-22s %12.3f %12.3f %8.2fx\n", "Kahn (DAG check)", tLinkedKahn, tKahn, tLinkedKahn / tKahn);
+    printf("Adjacency memory: linked ~%.1f MB (payload), CSR %.1f MB\n",
+           ((double)graph->E * sizeof(AdjListNode) + (double)V * sizeof(AdjListNode*)) / (1024.0 * 1024.0),
+           ((double)graph->E + V + 1) * sizeof(int) / (1024.0 * 1024.0));
+    printf("== Result: BFT orders %s, Kahn %s / %s ==\n", same ? "match" : "DIFFER",
+           dag ? "DAG" : "cycle", dagLinked ? "DAG" : "cycle");
+
+    free(order);
+    free(orderLinked);
+    freeLinkedAdjacency(adj, V);
+    freeGraph(graph);
+}
+
+int verifyTopologicalOrder(Graph* graph, int* order) {
+    int* position = (int*)malloc(graph->V * sizeof(int));
+    for (int i = 0; i < graph->V; i++)
+        position[order[i]] = i;
+    int valid = 1;
+    for (int e = 0; e < graph->E && valid; e++)
+        if (position[graph->edgeSrc[e]] >= position[graph->edgeDest[e]])
+            valid = 0;
+    free(position);
+    return valid;
+}
+
+void dfsStressTest() {
+    printf("\n--- Deep DFS Stress Test (long prerequisite chain) ---\n");
+    printf("Chain length in vertices (e.g. 10000000):\n");
+    int V = getInt();
+    if (V < 2) {
+        printf("!! Need at least 2 vertices.\n");
+        return;
+    }
+
+    Graph* graph = createGraph(V);
+    unsigned state = 2024;
+    for (int v = 0; v + 1 < V; v++)
+        appendEdge(graph, v, v + 1);
+    for (int i = 0; i < V; i++) {
+        int a = nextRandom(&state) % V;
+        int b = nextRandom(&state) % V;
+        if (a == b) continue;
+        if (a > b) { int t = a; a = b; b = t; }
+        appendEdge(graph, a, b);
+    }
+    freezeGraph(graph);
+    printf("-> Graph: %d vertices, %d edges, longest path %d.\n", V, graph->E, V - 1);
+
+    int* order = (int*)malloc(V * sizeof(int));
+
+    double t0 = nowSeconds();
+    int visited = DFT_order(graph, order);
+    double tDFT = nowSeconds() - t0;
+    printf("DFT:                %8.3f s  (%d vertices visited, %s)\n", tDFT, visited,
+           visited == V && order[0] == 0 ? "all reached" : "INCOMPLETE");
+
+    t0 = nowSeconds();
+    int dag = isDAG_DFT(graph);
+    double tDAG = nowSeconds() - t0;
+    printf("isDAG_DFT:          %8.3f s  (%s)\n", tDAG, dag ? "DAG" : "cycle");
+
+    t0 = nowSeconds();
+    int sorted = topoSort_DFT_order(graph, order);
+    double tTopo = nowSeconds() - t0;
+    printf("Topological (DFT):  %8.3f s  (%s)\n", tTopo,
+           sorted && verifyTopologicalOrder(graph, order) ? "order verified" : "INVALID");
+
+    appendEdge(graph, V - 1, 0);
+    printf("-> Added back edge %d -> 0.\n", V - 1);
+    t0 = nowSeconds();
+    dag = isDAG_DFT(graph);
+    double tCycle = nowSeconds() - t0;
+    printf("isDAG_DFT + back:   %8.3f s  (%s)\n", tCycle,
+           dag ? "MISSED CYCLE" : "cycle detected");
+
+    free(order);
+    freeGraph(graph);
+}
+
+Graph* generatePowerLawGraph(int scale, int edgeFactor, unsigned seed) {
+    int V = 1 << scale;
+    long E = (long)V * edgeFactor;
+    Graph* graph = createGraph(V);
+    unsigned state = seed ? seed : 1;
+    const unsigned A = (unsigned)(0.57 * 4294967295.0);
+    const unsigned AB = (unsigned)(0.76 * 4294967295.0);
+    const unsigned ABC = (unsigned)(0.95 * 4294967295.0);
+    for (long i = 0; i < E; i++) {
+        int src = 0, dest = 0;
+        for (int bit = scale - 1; bit >= 0; bit--) {
+            unsigned r = nextRandom(&state);
+            if (r < A) continue;
+            if (r < AB) dest |= 1 << bit;
+            else if (r < ABC) src |= 1 << bit;
+            else { src |= 1 << bit; dest |= 1 << bit; }
+        }
+        appendEdge(graph, src, dest);
+    }
+    return graph;
+}
+
+long reachableEdges(Graph* graph, BFSResult* result) {
+    long edges = 0;
+    for (int i = 0; i < result->count; i++) {
+        int v = result->order[i];
+        edges += graph->offsets[v + 1] - graph->offsets[v];
+    }
+    return edges;
+}
+
+int verifyBFSLevels(Graph* graph, BFSResult* result) {
+    for (int i = 0; i < result->count; i++) {
+        int u = result->order[i];
+        if (i > 0 && result->level[u] < result->level[result->order[i - 1]]) return 0;
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int w = graph->targets[e];
+            if (result->level[w] < 0 || result->level[w] > result->level[u] + 1) return 0;
+        }
+    }
+    return 1;
+}
+
+void bfsBenchmark() {
+    printf("\n--- Parallel BFS Benchmark (R-MAT power-law graph) ---\n");
+    printf("Scale (vertices = 2^scale, e.g. 20):\n");
+    int scale = getInt();
+    printf("Edge factor (edges per vertex, e.g. 16):\n");
+    int edgeFactor = getInt();
+    if (scale < 4 || scale > 26 || edgeFactor < 1 || ((long)edgeFactor << scale) > 1000000000L) {
+        printf("!! Scale must be 4..26 and total edges at most 10^9.\n");
+        return;
+    }
+
+    double t0 = nowSeconds();
+    Graph* graph = generatePowerLawGraph(scale, edgeFactor, 4242);
+    double tGen = nowSeconds() - t0;
+    t0 = nowSeconds();
+    freezeGraph(graph);
+    ensureTransposed(graph);
+    double tBuild = nowSeconds() - t0;
+
+    int root = 0;
+    for (int v = 1; v < graph->V; v++)
+        if (graph->offsets[v + 1] - graph->offsets[v] > graph->offsets[root + 1] - graph->offsets[root])
+            root = v;
+    printf("-> %d vertices, %d edges (generated in %.2f s, CSR + transpose in %.2f s), root %d.\n",
+           graph->V, graph->E, tGen, tBuild, root);
+
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    t0 = nowSeconds();
+    int seqCount = BFT_order(graph, order);
+    double tSeq = nowSeconds() - t0;
+    free(order);
+    printf("Sequential BFT (all vertices, array queue): %.3f s, %d vertices\n\n", tSeq, seqCount);
+
+    BFSResult reference;
+    parallelBFS(graph, root, 1, 0, &reference);
+    long edges = reachableEdges(graph, &reference);
+    int valid = verifyBFSLevels(graph, &reference);
+
+    printf("%-18s %7s %9s %10s %14s %8s %10s\n", "Mode", "Threads", "Time (s)", "Examined", "TEPS", "BU lvls", "Levels");
+    int maxThreads = defaultThreadCount() > 4 ? defaultThreadCount() : 4;
+    for (int mode = 0; mode < 2; mode++) {
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            BFSResult result;
+            t0 = nowSeconds();
+            parallelBFS(graph, root, threads, mode, &result);
+            double elapsed = nowSeconds() - t0;
+            if (result.count != reference.count ||
+                memcmp(result.level, reference.level, graph->V * sizeof(int)) != 0)
+                valid = 0;
+            printf("%-18s %7d %9.3f %10ld %14.3e %8d %10s\n", mode ? "Direction-optimal" : "Top-down",
+                   threads, elapsed, result.edgesExamined, edges / elapsed, result.bottomUpSteps,
+                   result.count == reference.count ? "match" : "DIFFER");
+            bfsResult_free(&result);
+        }
+    }
+    printf("\nReached %d vertices over %d levels; TEPS counts the %ld edges leaving them.\n",
+           reference.count, reference.levels, edges);
+    printf("== Result: BFS levels %s ==\n", valid ? "verified across all runs" : "MISMATCH");
+
+    bfsResult_free(&reference);
+    freeGraph(graph);
 }
 
-int getInt() {
-    int value, result;
-    do {
-        printf("> ");
-        result = scanf("%d", &value);
-        if (result != 1) {
-            printf("!! Invalid input. Please enter an integer.\n");
-            clearInputBuffer();
-        } else {
-            clearInputBuffer();
-            return value;
+Graph* generateLayeredDAG(int layers, int width, int degree, unsigned seed) {
+    int V = layers * width;
+    Graph* graph = createGraph(V);
+    unsigned state = seed ? seed : 1;
+    int* label = (int*)malloc(V * sizeof(int));
+    for (int v = 0; v < V; v++)
+        label[v] = v;
+    for (int v = V - 1; v > 0; v--) {
+        int j = nextRandom(&state) % (v + 1);
+        int t = label[v]; label[v] = label[j]; label[j] = t;
+    }
+    for (int layer = 0; layer + 1 < layers; layer++) {
+        for (int j = 0; j < width; j++) {
+            int src = label[layer * width + j];
+            for (int k = 0; k < degree; k++) {
+                int hop = 1 + (nextRandom(&state) % 4 == 0 ? nextRandom(&state) % 3 : 0);
+                int target = layer + hop < layers ? layer + hop : layers - 1;
+                appendEdge(graph, src, label[target * width + nextRandom(&state) % width]);
+            }
         }
-    } while (1);
+    }
+    free(label);
+    return graph;
 }
 
-Graph* createGraph(int V) {
-    Graph* graph = (Graph*)malloc(sizeof(Graph));
-    graph->V = V;
+void kahnBenchmark() {
+    printf("\n--- Parallel Kahn Benchmark (layered build DAG) ---\n");
+    printf("Number of layers (e.g. 1000):\n");
+    int layers = getInt();
+    printf("Vertices per layer (e.g. 1000):\n");
+    int width = getInt();
+    printf("Out-degree per vertex (e.g. 10):\n");
+    int degree = getInt();
+    if (layers < 2 || width < 1 || degree < 1 || (long)layers * width * degree > 500000000L) {
+        printf("!! Need >= 2 layers, positive width/degree and at most 5*10^8 edges.\n");
+        return;
+    }
 
-    graph->adj = (AdjListNode**)malloc(V * sizeof(AdjListNode*));
+    Graph* graph = generateLayeredDAG(layers, width, degree, 777);
+    freezeGraph(graph);
+    printf("-> %d vertices, %d edges.\n", graph->V, graph->E);
 
-    graph->in_degree = (int*)calloc(V, sizeof(int));
+    int* order = (int*)malloc(graph->V * sizeof(int));
+    double t0 = nowSeconds();
+    int seqCount = kahn_order(graph, order);
+    double tSeq = nowSeconds() - t0;
+    int valid = seqCount == graph->V && verifyTopologicalOrder(graph, order);
 
-    for (int i = 0; i < V; ++i)
-        graph->adj[i] = NULL;
+    printf("%-20s %7s %9s %9s %8s %s\n", "Variant", "Threads", "Time (s)", "Speedup", "Levels", "Order");
+    printf("%-20s %7d %9.3f %8.2fx %8s %s\n", "Sequential Kahn", 1, tSeq, 1.0, "-",
+           valid ? "valid" : "INVALID");
+    int maxThreads = defaultThreadCount() > 8 ? defaultThreadCount() : 8;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        int levels;
+        t0 = nowSeconds();
+        int count = parallelKahn_order(graph, threads, order, &levels);
+        double elapsed = nowSeconds() - t0;
+        int ok = count == graph->V && verifyTopologicalOrder(graph, order);
+        if (!ok) valid = 0;
+        printf("%-20s %7d %9.3f %8.2fx %8d %s\n", "Parallel Kahn", threads, elapsed, tSeq / elapsed,
+               levels, ok ? "valid" : "INVALID");
+    }
 
-    return graph;
+    appendEdge(graph, graph->edgeDest[graph->E - 1], graph->edgeSrc[0]);
+    for (int i = 0; i < width; i++)
+        appendEdge(graph, graph->edgeSrc[graph->E - 1 - i], graph->edgeSrc[i]);
+    int seqDAG = kahn_order(graph, order) == graph->V;
+    int parDAG = parallelKahn_order(graph, defaultThreadCount(), order, NULL) == graph->V;
+    printf("\nAfter adding back edges: sequential says %s, parallel says %s.\n",
+           seqDAG ? "DAG" : "cycle", parDAG ? "DAG" : "cycle");
+    printf("== Result: %s ==\n", valid && seqDAG == parDAG ? "orders valid and cycle detection agrees"
+                                                          : "MISMATCH");
+    free(order);
+    freeGraph(graph);
 }
 
-void addEdge(Graph* graph, int src, int dest) {
-    if (src >= graph->V || dest >= graph->V || src < 0 || dest < 0) {
-        printf("!! Invalid vertex number.\n");
+#define ONLINE_SAMPLES 20
+
+void onlineTopoBenchmark() {
+    printf("\n--- Online Topological Order Benchmark (Pearce-Kelly) ---\n");
+    printf("Number of vertices (e.g. 20000):\n");
+    int V = getInt();
+    printf("Edges to insert one at a time (e.g. 100000):\n");
+    int M = getInt();
+    if (V < 2 || M < ONLINE_SAMPLES) {
+        printf("!! Need at least 2 vertices and %d insertions.\n", ONLINE_SAMPLES);
         return;
     }
-    AdjListNode* newNode = (AdjListNode*)malloc(sizeof(AdjListNode));
-    newNode->dest = dest;
-    newNode->next = graph->adj[src];
-    graph->adj[src] = newNode;
 
-    graph->in_degree[dest]++;
+    unsigned state = 99;
+    int* rank = (int*)malloc(V * sizeof(int));
+    for (int v = 0; v < V; v++)
+        rank[v] = v;
+    for (int v = V - 1; v > 0; v--) {
+        int j = nextRandom(&state) % (v + 1);
+        int t = rank[v]; rank[v] = rank[j]; rank[j] = t;
+    }
 
-    printf("-> Edge from %d to %d added.\n", src, dest);
+    Graph* graph = createGraph(V);
+    enableOnlineTopo(graph);
+    int rejectedSrc[ONLINE_SAMPLES], rejectedDest[ONLINE_SAMPLES];
+    int rejectedKept = 0;
+    int* order = (int*)malloc(V * sizeof(int));
+    double naiveSample = 0;
+    int samples = 0;
+    double elapsed = 0;
+
+    for (int i = 0; i < M; i++) {
+        int a = nextRandom(&state) % V;
+        int b = nextRandom(&state) % V;
+        if (nextRandom(&state) % 10 != 0 && rank[a] > rank[b]) { int t = a; a = b; b = t; }
+
+        double t0 = nowSeconds();
+        int status = appendEdge(graph, a, b);
+        elapsed += nowSeconds() - t0;
+        if (status < 0 && rejectedKept < ONLINE_SAMPLES) {
+            rejectedSrc[rejectedKept] = a;
+            rejectedDest[rejectedKept] = b;
+            rejectedKept++;
+        }
+
+        if ((i + 1) % (M / ONLINE_SAMPLES) == 0 && samples < ONLINE_SAMPLES) {
+            t0 = nowSeconds();
+            kahn_order(graph, order);
+            naiveSample += nowSeconds() - t0;
+            samples++;
+        }
+    }
+
+    IncrementalTopo* topo = graph->online;
+    memcpy(order, topo->vertexAt, V * sizeof(int));
+    int valid = verifyTopologicalOrder(graph, order);
+    int confirmed = 0;
+    for (int i = 0; i < rejectedKept; i++) {
+        BFSResult reach;
+        parallelBFS(graph, rejectedDest[i], 1, 0, &reach);
+        if (rejectedSrc[i] == rejectedDest[i] || reach.level[rejectedSrc[i]] >= 0) confirmed++;
+        bfsResult_free(&reach);
+    }
+
+    double naiveTotal = naiveSample / samples * M;
+    printf("\n-> %ld accepted, %ld rejected, %ld insertions needed a reorder.\n",
+           topo->inserted, topo->rejected, topo->reordered);
+    printf("Online (Pearce-Kelly):   %9.3f s total, %.2f us/edge, %.1f vertices visited per reorder\n",
+           elapsed, elapsed / M * 1e6, topo->reordered ? (double)topo->visited / topo->reordered : 0.0);
+    printf("Full Kahn per insertion: %9.3f s estimated (%d sampled passes, %.2f ms each)\n",
+           naiveTotal, samples, naiveSample / samples * 1e3);
+    printf("== Result: order %s, %d/%d sampled rejections confirmed as cycles, %.0fx less work ==\n",
+           valid ? "valid" : "INVALID", confirmed, rejectedKept, naiveTotal / elapsed);
+
+    free(order);
+    free(rank);
+    freeGraph(graph);
 }
 
-void freeGraph(Graph* graph) {
-    if (graph == NULL) return;
-    for (int i = 0; i < graph->V; i++) {
-        AdjListNode* current = graph->adj[i];
-        while (current != NULL) {
-            AdjListNode* temp = current;
-            current = current->next;
-            free(temp);
+void addRandomCycles(Graph* graph, int count, unsigned seed) {
+    freezeGraph(graph);
+    unsigned state = seed ? seed : 1;
+    for (int i = 0; i < count; i++) {
+        int a = nextRandom(&state) % graph->V;
+        int v = a;
+        int steps = 1 + nextRandom(&state) % 8;
+        for (int k = 0; k < steps; k++) {
+            int degree = graph->offsets[v + 1] - graph->offsets[v];
+            if (degree == 0) break;
+            v = graph->targets[graph->offsets[v] + nextRandom(&state) % degree];
         }
+        if (v != a) appendEdge(graph, v, a);
     }
-    free(graph->adj);
-    free(graph->in_degree);
-    free(graph);
+    freezeGraph(graph);
 }
 
-void printGraph(Graph* graph) {
-    if (graph == NULL) {
-        printf("!! Graph not created yet.\n");
+void sccBenchmark() {
+    printf("\n--- SCC Benchmark (iterative Tarjan + condensation) ---\n");
+    printf("Number of vertices (e.g. 1000000):\n");
+    int V = getInt();
+    printf("Number of edges (e.g. 10000000):\n");
+    int E = getInt();
+    printf("Back edges creating cycles (e.g. 2000):\n");
+    int back = getInt();
+    if (V < 2 || E < 0 || back < 0) {
+        printf("!! Need at least 2 vertices and non-negative edge counts.\n");
         return;
     }
-    printf("\n--- Graph Adjacency List ---\n");
-    for (int v = 0; v < graph->V; ++v) {
-        AdjListNode* temp = graph->adj[v];
 
-        printf("Vertex %d (in-degree: %d): ", v, graph->in_degree[v]);
-        while (temp) {
-            printf("-> %d ", temp->dest);
-            temp = temp->next;
+    Graph* graph = generateRandomDAG(V, E, 31337);
+    addRandomCycles(graph, back, 7);
+    printf("-> %d vertices, %d edges.\n", graph->V, graph->E);
+
+    SCCResult result;
+    double t0 = nowSeconds();
+    scc_tarjan(graph, &result);
+    double tTarjan = nowSeconds() - t0;
+    t0 = nowSeconds();
+    scc_buildCondensation(graph, &result);
+    double tCondense = nowSeconds() - t0;
+
+    int cyclic = 0, largest = 0;
+    for (int c = 0; c < result.count; c++) {
+        if (isCyclicComponent(graph, &result, c)) cyclic++;
+        if (result.compSize[c] > largest) largest = result.compSize[c];
+    }
+    int ordered = 1;
+    Graph* dag = result.condensation;
+    for (int e = 0; e < dag->E; e++)
+        if (dag->edgeSrc[e] >= dag->edgeDest[e])
+            ordered = 0;
+    int* order = (int*)malloc(dag->V * sizeof(int));
+    int isDAG = kahn_order(dag, order) == dag->V;
+    free(order);
+
+    printf("Tarjan (iterative):   %8.3f s  -> %d components, %d cyclic, largest %d\n",
+           tTarjan, result.count, cyclic, largest);
+    printf("Condensation DAG:     %8.3f s  -> %d vertices, %d edges\n", tCondense, dag->V, dag->E);
+    printf("Throughput: %.1f M edges/s\n", graph->E / (tTarjan + tCondense) / 1e6);
+    printf("== Result: condensation %s, component ids %s ==\n", isDAG ? "is a DAG" : "HAS A CYCLE",
+           ordered ? "in topological order" : "NOT ORDERED");
+    scc_free(&result);
+    freeGraph(graph);
+}
+
+int singleSourceReach(Graph* graph, int s, int* stamp, int mark, int* queue, int* dist) {
+    int head = 0, tail = 0;
+    stamp[s] = mark;
+    dist[s] = 0;
+    queue[tail++] = s;
+    while (head < tail) {
+        int v = queue[head++];
+        for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+            int w = graph->targets[e];
+            if (stamp[w] != mark) {
+                stamp[w] = mark;
+                dist[w] = dist[v] + 1;
+                queue[tail++] = w;
+            }
         }
-        printf("\n");
     }
+    return tail;
+}
+
+void msbfsBenchmark() {
+    printf("\n--- Multi-Source BFS Benchmark (R-MAT power-law graph) ---\n");
+    printf("Scale (vertices = 2^scale, e.g. 18):\n");
+    int scale = getInt();
+    printf("Number of sources (e.g. 512):\n");
+    int nSources = getInt();
+    if (scale < 4 || scale > 24 || nSources < 1 || nSources > (1 << scale)) {
+        printf("!! Scale must be 4..24 and sources between 1 and 2^scale.\n");
+        return;
+    }
+
+    Graph* graph = generatePowerLawGraph(scale, 16, 1717);
+    freezeGraph(graph);
+    int V = graph->V;
+    int* sources = (int*)malloc(nSources * sizeof(int));
+    unsigned state = 55;
+    for (int i = 0; i < nSources; i++) {
+        int s;
+        do s = nextRandom(&state) % V; while (graph->offsets[s + 1] == graph->offsets[s]);
+        sources[i] = s;
+    }
+    printf("-> %d vertices, %d edges, %d sources.\n", V, graph->E, nSources);
+
+    MSBFSResult result;
+    double t0 = nowSeconds();
+    msbfs_run(graph, sources, nSources, 0, &result);
+    double tMulti = nowSeconds() - t0;
+
+    int* stamp = (int*)calloc(V, sizeof(int));
+    int* queue = (int*)malloc(V * sizeof(int));
+    int* dist = (int*)malloc(V * sizeof(int));
+    long pairs = 0;
+    int mismatches = 0;
+    t0 = nowSeconds();
+    for (int i = 0; i < nSources; i++) {
+        int count = singleSourceReach(graph, sources[i], stamp, i + 1, queue, dist);
+        pairs += count;
+        if (count != result.reachCount[i]) mismatches++;
+    }
+    double tSingle = nowSeconds() - t0;
+
+    for (int i = 0; i < nSources && i < 8; i++) {
+        singleSourceReach(graph, sources[i], stamp, nSources + i + 1, queue, dist);
+        for (int v = 0; v < V; v++)
+            if ((stamp[v] == nSources + i + 1) != msbfs_reaches(&result, i, v)) {
+                mismatches++;
+                break;
+            }
+    }
+
+    printf("%-26s %9s %14s %9s\n", "Method", "Time (s)", "Pairs/s", "Speedup");
+    printf("%-26s %9.3f %14.3e %8.2fx\n", "Repeated single-source BFS", tSingle, pairs / tSingle, 1.0);
+    printf("%-26s %9.3f %14.3e %8.2fx\n", "Multi-source BFS (256/pass)", tMulti, pairs / tMulti, tSingle / tMulti);
+    printf("Reachable (source, vertex) pairs: %ld; reachable-set matrix %.1f MB\n",
+           pairs, (double)V * result.words * sizeof(uint64_t) / (1024.0 * 1024.0));
+    printf("== Result: %s ==\n", mismatches == 0 ? "reachable sets match" : "MISMATCH");
+
+    free(stamp);
+    free(queue);
+    free(dist);
+    free(sources);
+    msbfs_free(&result);
+    freeGraph(graph);
 }
 
-void DFTUtil(Graph* graph, int v, int visited[]) {
-    visited[v] = 1;
-    printf("%d ", v);
-    AdjListNode* temp = graph->adj[v];
-    while (temp != NULL) {
-        if (!visited[temp->dest])
-            DFTUtil(graph, temp->dest, visited);
-        temp = temp->next;
+int bfsCanReach(Graph* graph, int u, int v, int* stamp, int mark, int* queue) {
+    if (u == v) return 1;
+    int head = 0, tail = 0;
+    stamp[u] = mark;
+    queue[tail++] = u;
+    while (head < tail) {
+        int x = queue[head++];
+        for (int e = graph->offsets[x]; e < graph->offsets[x + 1]; e++) {
+            int w = graph->targets[e];
+            if (w == v) return 1;
+            if (stamp[w] != mark) {
+                stamp[w] = mark;
+                queue[tail++] = w;
+            }
+        }
     }
+    return 0;
 }
 
-void DFT(Graph* graph) {
-    if (graph == NULL) {
-        printf("!! Graph not created yet.\n");
+#define REACH_QUERIES 10000000
+#define REACH_TRAVERSAL_QUERIES 2000
+
+void reachIndexBenchmark() {
+    printf("\n--- Reachability Index Benchmark (SCC + tree-cover intervals) ---\n");
+    printf("Number of layers (e.g. 400):\n");
+    int layers = getInt();
+    printf("Vertices per layer (e.g. 500):\n");
+    int width = getInt();
+    printf("Out-degree per vertex (e.g. 3):\n");
+    int degree = getInt();
+    if (layers < 2 || width < 1 || degree < 1 || (long)layers * width * degree > 100000000L) {
+        printf("!! Need >= 2 layers, positive width/degree and at most 10^8 edges.\n");
         return;
     }
-    int* visited = (int*)calloc(graph->V, sizeof(int));
-    printf("Depth First Traversal: ");
-    for (int i = 0; i < graph->V; i++)
-        if (!visited[i])
-            DFTUtil(graph, i, visited);
-    printf("\n");
-    free(visited);
+
+    Graph* graph = generateLayeredDAG(layers, width, degree, 4711);
+    addRandomCycles(graph, width, 8);
+    int V = graph->V;
+    printf("-> %d vertices, %d edges (with %d cycle-closing edges).\n", V, graph->E, width);
+
+    ReachIndex index;
+    double t0 = nowSeconds();
+    reach_build(graph, &index);
+    double tBuild = nowSeconds() - t0;
+    size_t bytes = reach_memoryBytes(&index, V);
+    printf("Build: %.3f s -> %d components, %ld intervals (%.2f per component), %.1f MB\n",
+           tBuild, index.scc.count, index.totalIntervals,
+           (double)index.totalIntervals / index.scc.count, bytes / (1024.0 * 1024.0));
+    printf("       (full closure bit matrix would need %.1f MB)\n",
+           (double)index.scc.count * index.scc.count / 8.0 / (1024.0 * 1024.0));
+
+    int nSources = MSBFS_LANES;
+    int* sources = (int*)malloc(nSources * sizeof(int));
+    unsigned state = 21;
+    for (int i = 0; i < nSources; i++)
+        sources[i] = nextRandom(&state) % V;
+    MSBFSResult truth;
+    msbfs_run(graph, sources, nSources, 0, &truth);
+    long mismatches = 0;
+    for (int i = 0; i < nSources; i++)
+        for (int v = 0; v < V; v++)
+            if (reach_query(&index, sources[i], v) != msbfs_reaches(&truth, i, v))
+                mismatches++;
+    msbfs_free(&truth);
+    free(sources);
+
+    int* qu = (int*)malloc(REACH_QUERIES * sizeof(int));
+    int* qv = (int*)malloc(REACH_QUERIES * sizeof(int));
+    for (int i = 0; i < REACH_QUERIES; i++) {
+        qu[i] = nextRandom(&state) % V;
+        qv[i] = nextRandom(&state) % V;
+    }
+    long positive = 0;
+    t0 = nowSeconds();
+    for (int i = 0; i < REACH_QUERIES; i++)
+        positive += reach_query(&index, qu[i], qv[i]);
+    double tIndex = nowSeconds() - t0;
+
+    int* stamp = (int*)calloc(V, sizeof(int));
+    int* queue = (int*)malloc(V * sizeof(int));
+    t0 = nowSeconds();
+    for (int i = 0; i < REACH_TRAVERSAL_QUERIES; i++)
+        if (bfsCanReach(graph, qu[i], qv[i], stamp, i + 1, queue) != reach_query(&index, qu[i], qv[i]))
+            mismatches++;
+    double tTraversal = nowSeconds() - t0;
+
+    printf("%-20s %12s %14s\n", "Method", "Queries", "ns/query");
+    printf("%-20s %12d %14.1f\n", "BFS per query", REACH_TRAVERSAL_QUERIES, tTraversal / REACH_TRAVERSAL_QUERIES * 1e9);
+    printf("%-20s %12d %14.1f\n", "Interval index", REACH_QUERIES, tIndex / REACH_QUERIES * 1e9);
+    printf("%.1f%% of random queries were reachable; index is %.0fx faster per query.\n",
+           100.0 * positive / REACH_QUERIES, (tTraversal / REACH_TRAVERSAL_QUERIES) / (tIndex / REACH_QUERIES));
+    printf("== Result: %s ==\n", mismatches == 0 ? "index agrees with traversal" : "MISMATCH");
+
+    free(stamp);
+    free(queue);
+    free(qu);
+    free(qv);
+    reach_free(&index);
+    freeGraph(graph);
 }
 
-void BFT(Graph* graph) {
+void reachabilityQueries(Graph* graph) {
     if (graph == NULL) {
         printf("!! Graph not created yet.\n");
         return;
     }
-    int* visited = (int*)calloc(graph->V, sizeof(int));
-    Queue* q = createQueue();
-    printf("Breadth First Traversal: ");
-    for (int i = 0; i < graph->V; i++) {
-        if (!visited[i]) {
-            visited[i] = 1;
-            enqueue(q, i);
-            while (!isQueueEmpty(q)) {
-                int v = dequeue(q);
-                printf("%d ", v);
-                AdjListNode* temp = graph->adj[v];
-                while (temp != NULL) {
-                    if (!visited[temp->dest]) {
-                        visited[temp->dest] = 1;
-                        enqueue(q, temp->dest);
-                    }
-                    temp = temp->next;
-                }
-            }
+    ReachIndex index;
+    double t0 = nowSeconds();
+    reach_build(graph, &index);
+    printf("-> Index built in %.3f ms: %d components, %ld intervals, %zu bytes.\n",
+           (nowSeconds() - t0) * 1e3, index.scc.count, index.totalIntervals, reach_memoryBytes(&index, graph->V));
+    printf("Enter queries as 'u v' (can u reach v?). Type '-1 -1' to stop.\n");
+    while (1) {
+        int u, v;
+        printf("Query (u v): ");
+        if (scanf("%d %d", &u, &v) != 2) {
+            clearInputBuffer();
+            break;
         }
+        clearInputBuffer();
+        if (u == -1 || v == -1) break;
+        if (u < 0 || v < 0 || u >= graph->V || v >= graph->V) {
+            printf("!! Invalid vertex number.\n");
+            continue;
+        }
+        printf("-> %d %s %d\n", u, reach_query(&index, lookupId(graph, u), lookupId(graph, v)) ? "can reach" : "cannot reach", v);
     }
-    printf("\n");
-    free(visited);
-    free(q);
+    reach_free(&index);
 }
 
-int isDAG_DFT_Util(Graph* graph, int v, int visited[], int recStack[]) {
-    if (visited[v] == 0) {
-        visited[v] = 1;
-        recStack[v] = 1;
-        AdjListNode* temp = graph->adj[v];
-        while (temp != NULL) {
-            if (!visited[temp->dest] && isDAG_DFT_Util(graph, temp->dest, visited, recStack))
-                return 1;
-            else if (recStack[temp->dest])
-                return 1;
-            temp = temp->next;
+Graph* scanfEdgeList(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) return NULL;
+    int capacity = 1024, n = 0, maxVertex = -1;
+    int* src = (int*)malloc(capacity * sizeof(int));
+    int* dest = (int*)malloc(capacity * sizeof(int));
+    char line[256];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        int a, b;
+        if (line[0] == '#' || sscanf(line, "%d %d", &a, &b) != 2) continue;
+        if (n == capacity) {
+            capacity *= 2;
+            src = (int*)realloc(src, capacity * sizeof(int));
+            dest = (int*)realloc(dest, capacity * sizeof(int));
         }
+        src[n] = a;
+        dest[n] = b;
+        n++;
+        if (a > maxVertex) maxVertex = a;
+        if (b > maxVertex) maxVertex = b;
     }
-    recStack[v] = 0;
-    return 0;
+    fclose(f);
+    return graphFromEdges(maxVertex + 1, src, dest, n);
 }
 
-int isDAG_DFT(Graph* graph) {
-    if (graph == NULL) {
-        printf("!! Graph not created yet.\n");
-        return 0;
+void loaderBenchmark() {
+    printf("\n--- Edge-List Loader Benchmark ---\n");
+    printf("R-MAT scale (vertices = 2^scale, e.g. 20):\n");
+    int scale = getInt();
+    printf("Edge factor (e.g. 16):\n");
+    int edgeFactor = getInt();
+    if (scale < 4 || scale > 26 || edgeFactor < 1 || ((long)edgeFactor << scale) > 200000000L) {
+        printf("!! Scale must be 4..26 and total edges at most 2*10^8.\n");
+        return;
     }
-    int* visited = (int*)calloc(graph->V, sizeof(int));
-    int* recStack = (int*)calloc(graph->V, sizeof(int));
-    for (int i = 0; i < graph->V; i++)
-        if (isDAG_DFT_Util(graph, i, visited, recStack)) {
-            free(visited);
-            free(recStack);
-            return 0;
+    const char* textPath = "/tmp/lab4_edges.txt";
+    const char* binaryPath = "/tmp/lab4_edges.bin";
+    Graph* graph = generatePowerLawGraph(scale, edgeFactor, 99);
+    double t0 = nowSeconds();
+    int ok = saveEdgeListFile(graph, textPath, 0) && saveEdgeListFile(graph, binaryPath, 1);
+    printf("-> Wrote %d edges as text and binary in %.2f s.\n", graph->E, nowSeconds() - t0);
+    int V = graph->V, E = graph->E;
+    long checksum = 0;
+    for (int e = 0; e < E; e++)
+        checksum += (long)graph->edgeSrc[e] * 31 + graph->edgeDest[e];
+    freeGraph(graph);
+    if (!ok) return;
+
+    printf("%-24s %7s %9s %12s %12s %s\n", "Loader", "Threads", "Time (s)", "M edges/s", "Peak RSS MB", "Check");
+    int maxThreads = defaultThreadCount() > 4 ? defaultThreadCount() : 4;
+    for (int variant = 0; variant < 5; variant++) {
+        const char* name;
+        int threads = 1;
+        LoadStats stats;
+        resetPeakResident();
+        t0 = nowSeconds();
+        Graph* loaded;
+        if (variant == 0) {
+            name = "fgets + sscanf";
+            loaded = scanfEdgeList(textPath);
+        } else {
+            int binary = variant >= 3;
+            threads = (variant == 1 || variant == 3) ? 1 : maxThreads;
+            name = binary ? "mmap binary" : "mmap text";
+            loaded = loadEdgeListFile(binary ? binaryPath : textPath, threads, &stats);
         }
-    free(visited);
-    free(recStack);
+        double elapsed = nowSeconds() - t0;
+        long peak = peakResidentKB();
+        long sum = 0;
+        if (loaded != NULL)
+            for (int e = 0; e < loaded->E; e++)
+                sum += (long)loaded->edgeSrc[e] * 31 + loaded->edgeDest[e];
+        int match = loaded != NULL && loaded->E == E && loaded->V <= V && sum == checksum;
+        printf("%-24s %7d %9.3f %12.2f %12.1f %s\n", name, threads, elapsed, E / elapsed / 1e6,
+               peak / 1024.0, match ? "ok" : "MISMATCH");
+        freeGraph(loaded);
+    }
+    printf("Peak RSS is reset before each load when the kernel allows it (/proc/self/clear_refs).\n");
+    remove(textPath);
+    remove(binaryPath);
+}
+
+#define EXEC_EMPTY -1
+#define EXEC_ABORT -2
+
+typedef void (*TaskFn)(int v, void* ctx);
+
+typedef struct WorkDeque {
+    int* items;
+    long mask;
+    long top;
+    long bottom;
+    char pad[64];
+} WorkDeque;
+
+void deque_init(WorkDeque* dq, int capacity) {
+    long size = 1;
+    while (size < capacity) size <<= 1;
+    dq->items = (int*)malloc(size * sizeof(int));
+    if (dq->items == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    dq->mask = size - 1;
+    dq->top = 0;
+    dq->bottom = 0;
+}
+
+void deque_push(WorkDeque* dq, int v) {
+    long b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->items[b & dq->mask], v, __ATOMIC_RELAXED);
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELEASE);
+}
+
+int deque_take(WorkDeque* dq) {
+    long b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+    if (t > b) {
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+        return EXEC_EMPTY;
+    }
+    int v = __atomic_load_n(&dq->items[b & dq->mask], __ATOMIC_RELAXED);
+    if (t == b) {
+        if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            v = EXEC_EMPTY;
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return v;
+}
+
+int deque_steal(WorkDeque* dq) {
+    long t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return EXEC_EMPTY;
+    int v = __atomic_load_n(&dq->items[t & dq->mask], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&dq->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        return EXEC_ABORT;
+    return v;
+}
+
+typedef struct ExecReport {
+    double makespan;
+    double totalWork;
+    double criticalPath;
+    int* criticalTasks;
+    int criticalLength;
+    double* start;
+    double* finish;
+    int* worker;
+    long steals;
+    int threads;
+} ExecReport;
+
+typedef struct DagExecutor {
+    Graph* graph;
+    TaskFn task;
+    void* ctx;
+    int threads;
+    int* pending;
+    WorkDeque* deques;
+    int remaining;
+    long steals;
+    double t0;
+    ExecReport* report;
+} DagExecutor;
+
+typedef struct ExecWorker {
+    DagExecutor* exec;
+    int id;
+} ExecWorker;
+
+void exec_runTask(DagExecutor* exec, int id, int v) {
+    Graph* graph = exec->graph;
+    exec->report->start[v] = nowSeconds() - exec->t0;
+    exec->task(v, exec->ctx);
+    exec->report->finish[v] = nowSeconds() - exec->t0;
+    exec->report->worker[v] = id;
+    for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+        int w = graph->targets[e];
+        if (__atomic_sub_fetch(&exec->pending[w], 1, __ATOMIC_ACQ_REL) == 0)
+            deque_push(&exec->deques[id], w);
+    }
+    __atomic_sub_fetch(&exec->remaining, 1, __ATOMIC_ACQ_REL);
+}
+
+void* exec_worker(void* arg) {
+    ExecWorker* self = (ExecWorker*)arg;
+    DagExecutor* exec = self->exec;
+    int id = self->id;
+    unsigned state = 2166136261u ^ (unsigned)(id * 16777619);
+    long steals = 0;
+    while (__atomic_load_n(&exec->remaining, __ATOMIC_ACQUIRE) > 0) {
+        int v = deque_take(&exec->deques[id]);
+        if (v < 0 && exec->threads > 1) {
+            int victim = nextRandom(&state) % exec->threads;
+            for (int k = 0; k < exec->threads && v < 0; k++, victim = (victim + 1) % exec->threads)
+                if (victim != id) {
+                    v = deque_steal(&exec->deques[victim]);
+                    if (v >= 0) steals++;
+                }
+        }
+        if (v >= 0) exec_runTask(exec, id, v);
+        else sched_yield();
+    }
+    __atomic_fetch_add(&exec->steals, steals, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+void exec_criticalPath(Graph* graph, ExecReport* report) {
+    int V = graph->V;
+    int* order = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    double* best = (double*)calloc(V > 0 ? V : 1, sizeof(double));
+    int* via = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (order == NULL || best == NULL || via == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    kahn_order(graph, order);
+    for (int v = 0; v < V; v++)
+        via[v] = -1;
+    int tail = -1;
+    report->criticalPath = 0;
+    report->totalWork = 0;
+    for (int i = 0; i < V; i++) {
+        int v = order[i];
+        double duration = report->finish[v] - report->start[v];
+        double done = best[v] + duration;
+        report->totalWork += duration;
+        if (done > report->criticalPath) {
+            report->criticalPath = done;
+            tail = v;
+        }
+        for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+            int w = graph->targets[e];
+            if (done > best[w]) {
+                best[w] = done;
+                via[w] = v;
+            }
+        }
+    }
+    report->criticalLength = 0;
+    report->criticalTasks = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (report->criticalTasks == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    for (int v = tail; v != -1; v = via[v])
+        report->criticalTasks[report->criticalLength++] = v;
+    for (int i = 0, j = report->criticalLength - 1; i < j; i++, j--) {
+        int t = report->criticalTasks[i];
+        report->criticalTasks[i] = report->criticalTasks[j];
+        report->criticalTasks[j] = t;
+    }
+    free(order);
+    free(best);
+    free(via);
+}
+
+int executeDAG(Graph* graph, int threads, TaskFn task, void* ctx, ExecReport* report) {
+    ensureFrozen(graph);
+    int V = graph->V;
+    int* order = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (order == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    int isDAG = kahn_order(graph, order) == V;
+    free(order);
+    if (!isDAG) return 0;
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    DagExecutor exec;
+    exec.graph = graph;
+    exec.task = task;
+    exec.ctx = ctx;
+    exec.threads = threads;
+    exec.pending = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    exec.deques = (WorkDeque*)malloc(threads * sizeof(WorkDeque));
+    if (exec.pending == NULL || exec.deques == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(exec.pending, graph->in_degree, V * sizeof(int));
+    exec.remaining = V;
+    exec.steals = 0;
+    exec.report = report;
+    report->start = (double*)malloc((V > 0 ? V : 1) * sizeof(double));
+    report->finish = (double*)malloc((V > 0 ? V : 1) * sizeof(double));
+    report->worker = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (report->start == NULL || report->finish == NULL || report->worker == NULL) {
+        printf("!! Fatal Error: Memory allocation failed.\n");
+        exit(1);
+    }
+    report->threads = threads;
+    for (int t = 0; t < threads; t++)
+        deque_init(&exec.deques[t], V);
+    int seeded = 0;
+    for (int v = 0; v < V; v++)
+        if (graph->in_degree[v] == 0)
+            deque_push(&exec.deques[seeded++ % threads], v);
+
+    ExecWorker workers[MAX_THREADS];
+    pthread_t handles[MAX_THREADS];
+    exec.t0 = nowSeconds();
+    for (int t = 0; t < threads; t++) {
+        workers[t].exec = &exec;
+        workers[t].id = t;
+        if (t > 0) pthread_create(&handles[t], NULL, exec_worker, &workers[t]);
+    }
+    exec_worker(&workers[0]);
+    for (int t = 1; t < threads; t++)
+        pthread_join(handles[t], NULL);
+    report->makespan = nowSeconds() - exec.t0;
+    report->steals = exec.steals;
+
+    for (int t = 0; t < threads; t++)
+        free(exec.deques[t].items);
+    free(exec.deques);
+    free(exec.pending);
+    exec_criticalPath(graph, report);
     return 1;
 }
 
-void topoSort_DFT_Util(Graph* graph, int v, int visited[], int* stack, int* stackIndex) {
-    visited[v] = 1;
-    AdjListNode* temp = graph->adj[v];
-    while (temp != NULL) {
-        if (!visited[temp->dest])
-            topoSort_DFT_Util(graph, temp->dest, visited, stack, stackIndex);
-        temp = temp->next;
+void execReport_free(ExecReport* report) {
+    free(report->start);
+    free(report->finish);
+    free(report->worker);
+    free(report->criticalTasks);
+}
+
+typedef struct SimulatedTask {
+    int sleepTask;
+    int baseMicros;
+    int spreadMicros;
+} SimulatedTask;
+
+int simulatedMicros(SimulatedTask* sim, int v) {
+    unsigned h = (unsigned)v * 2654435761u;
+    return sim->baseMicros + (sim->spreadMicros > 0 ? (int)((h >> 8) % sim->spreadMicros) : 0);
+}
+
+void simulatedTask(int v, void* ctx) {
+    SimulatedTask* sim = (SimulatedTask*)ctx;
+    int micros = simulatedMicros(sim, v);
+    if (sim->sleepTask) {
+        struct timespec ts = { micros / 1000000, (micros % 1000000) * 1000L };
+        nanosleep(&ts, NULL);
+    } else {
+        double until = nowSeconds() + micros / 1e6;
+        volatile unsigned sink = 0;
+        while (nowSeconds() < until)
+            for (int i = 0; i < 64; i++) sink += i;
     }
-    stack[(*stackIndex)++] = v;
 }
 
-void topologicalSort_DFT(Graph* graph) {
+void printExecSummary(ExecReport* report) {
+    printf("Makespan %.3f s | total work %.3f s | critical path %.3f s (%d tasks) | parallelism %.2f | steals %ld\n",
+           report->makespan, report->totalWork, report->criticalPath, report->criticalLength,
+           report->criticalPath > 0 ? report->totalWork / report->criticalPath : 0.0, report->steals);
+}
+
+void executePipeline(Graph* graph) {
     if (graph == NULL) {
         printf("!! Graph not created yet.\n");
         return;
     }
-    if (!isDAG_DFT(graph)) {
-        printf("!! Error: Graph contains a cycle. Topological sort not possible.\n");
+    printf("Milliseconds per simulated task (e.g. 50):\n");
+    int ms = getInt();
+    if (ms < 0) ms = 0;
+    SimulatedTask sim = { 1, ms * 1000, ms * 1000 };
+    ExecReport report;
+    if (!executeDAG(graph, defaultThreadCount() > 4 ? defaultThreadCount() : 4, simulatedTask, &sim, &report)) {
+        printf("!! Error: Graph contains a cycle. Tasks cannot be scheduled.\n");
         return;
     }
-    int* stack = (int*)malloc(graph->V * sizeof(int));
-    int stackIndex = 0;
-    int* visited = (int*)calloc(graph->V, sizeof(int));
-
-    for (int i = 0; i < graph->V; i++)
-        if (!visited[i])
-            topoSort_DFT_Util(graph, i, visited, stack, &stackIndex);
-
-    printf("Topological Sort (DFT-Based): ");
-    while (stackIndex > 0)
-        printf("%d ", stack[--stackIndex]);
+    printf("\n%-8s %-8s %12s %12s\n", "Task", "Thread", "Start (ms)", "Time (ms)");
+    for (int v = 0; v < graph->V && v < 50; v++)
+        printf("%-8d %-8d %12.1f %12.1f\n", displayId(graph, v), report.worker[v], report.start[v] * 1e3,
+               (report.finish[v] - report.start[v]) * 1e3);
+    if (graph->V > 50) printf("... (%d more tasks)\n", graph->V - 50);
+    printf("Critical path: ");
+    for (int i = 0; i < report.criticalLength; i++)
+        printf(i ? " -> %d" : "%d", displayId(graph, report.criticalTasks[i]));
     printf("\n");
-    free(stack);
-    free(visited);
+    printExecSummary(&report);
+    execReport_free(&report);
 }
 
-int topologicalSort_Kahn(Graph* graph, int printSort) {
-    if (graph == NULL) {
-        printf("!! Graph not created yet.\n");
-        return 0;
+void executorBenchmark() {
+    printf("\n--- DAG Executor Benchmark (work-stealing pool) ---\n");
+    printf("Number of layers (e.g. 20):\n");
+    int layers = getInt();
+    printf("Tasks per layer (e.g. 200):\n");
+    int width = getInt();
+    printf("Microseconds per task (e.g. 500):\n");
+    int micros = getInt();
+    printf("Task kind: 1. CPU spin  2. Sleep (I/O-bound)\n");
+    int sleepTask = getInt() == 2;
+    if (layers < 1 || width < 1 || micros < 0 || (long)layers * width > 10000000L) {
+        printf("!! Need positive layers/width, non-negative duration and at most 10^7 tasks.\n");
+        return;
     }
+    Graph* graph = generateLayeredDAG(layers, width, 3, 2023);
+    freezeGraph(graph);
+    SimulatedTask sim = { sleepTask, micros, micros / 2 };
+    printf("-> %d tasks, %d dependencies, %s tasks.\n", graph->V, graph->E, sleepTask ? "sleeping" : "spinning");
 
-    int* in_degree_copy = (int*)malloc(graph->V * sizeof(int));
-    for (int i = 0; i < graph->V; i++)
-        in_degree_copy[i] = graph->in_degree[i];
+    printf("%-8s %10s %9s %12s %10s %8s\n", "Threads", "Time (s)", "Speedup", "Critical (s)", "Bound", "Steals");
+    double base = 0;
+    int maxThreads = defaultThreadCount() > 8 ? defaultThreadCount() : 8;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ExecReport report;
+        executeDAG(graph, threads, simulatedTask, &sim, &report);
+        if (threads == 1) base = report.makespan;
+        double bound = report.criticalPath > 0 ? report.totalWork / report.criticalPath : threads;
+        printf("%-8d %10.3f %8.2fx %12.3f %9.1fx %8ld\n", threads, report.makespan,
+               report.makespan > 0 ? base / report.makespan : 1.0,
+               report.criticalPath, bound < threads ? bound : threads, report.steals);
+        execReport_free(&report);
+    }
+    printf("Bound = min(threads, total work / critical path), the best achievable speedup.\n");
+    printf("This machine has %d online CPU(s); CPU-bound tasks cannot scale past that.\n", defaultThreadCount());
+    freeGraph(graph);
+}
 
-    Queue* q = createQueue();
-    for (int i = 0; i < graph->V; i++)
-        if (in_degree_copy[i] == 0)
-            enqueue(q, i);
+uint64_t edgeChecksum(Graph* graph) {
+    uint64_t sum = 0;
+    for (int e = 0; e < graph->E; e++) {
+        uint64_t key = (uint64_t)displayId(graph, graph->edgeSrc[e]) << 32 | (uint32_t)displayId(graph, graph->edgeDest[e]);
+        sum += key * 0x9E3779B97F4A7C15ULL ^ key >> 29;
+    }
+    return sum;
+}
 
-    int count = 0;
-    int* sortedOrder = (int*)malloc(graph->V * sizeof(int));
+void reorderBenchmark() {
+    printf("\n--- Vertex Reordering Benchmark (R-MAT graph, scrambled labels) ---\n");
+    printf("Scale (vertices = 2^scale, e.g. 20):\n");
+    int scale = getInt();
+    printf("Edge factor (edges per vertex, e.g. 16):\n");
+    int edgeFactor = getInt();
+    if (scale < 4 || scale > 24 || edgeFactor < 1 || ((long)edgeFactor << scale) > 400000000L) {
+        printf("!! Scale must be 4..24 and total edges at most 4*10^8.\n");
+        return;
+    }
 
-    while (!isQueueEmpty(q)) {
-        int u = dequeue(q);
-        sortedOrder[count] = u;
-        count++;
+    Graph* generated = generatePowerLawGraph(scale, edgeFactor, 4242);
+    int V = generated->V;
+    int* order = (int*)malloc(V * sizeof(int));
+    int* visit = (int*)malloc(V * sizeof(int));
+    unsigned state = 99;
+    for (int v = 0; v < V; v++)
+        order[v] = v;
+    for (int v = V - 1; v > 0; v--) {
+        int j = nextRandom(&state) % (v + 1);
+        int t = order[v]; order[v] = order[j]; order[j] = t;
+    }
+    Graph* scrambled = relabelGraph(generated, order);
+    freeGraph(generated);
+    uint64_t checksum = edgeChecksum(scrambled);
+    printf("-> %d vertices, %d edges, labels shuffled as if typed in arbitrary order.\n", V, scrambled->E);
 
-        AdjListNode* temp = graph->adj[u];
-        while (temp != NULL) {
-            in_degree_copy[temp->dest]--;
-            if (in_degree_copy[temp->dest] == 0)
-                enqueue(q, temp->dest);
-            temp = temp->next;
+    printf("%-22s %10s %9s %9s %9s %11s %8s\n", "Order", "Build (ms)", "Edge span", "BFT (ms)", "DFT (ms)",
+           "BFS-1T (ms)", "Speedup");
+    int valid = 1;
+    double baseline = 0.0;
+    for (int method = REORDER_NONE; method <= REORDER_DEGREE; method++) {
+        double t0 = nowSeconds();
+        Graph* graph = scrambled;
+        if (method != REORDER_NONE) {
+            reorder_order(scrambled, method, order);
+            graph = relabelGraph(scrambled, order);
         }
+        double tBuild = nowSeconds() - t0;
+        ensureFrozen(graph);
+
+        t0 = nowSeconds();
+        int bftCount = BFT_order(graph, visit);
+        double tBFT = nowSeconds() - t0;
+        t0 = nowSeconds();
+        int dftCount = DFT_order(graph, visit);
+        double tDFT = nowSeconds() - t0;
+        BFSResult result;
+        t0 = nowSeconds();
+        parallelBFS(graph, -1, 1, 0, &result);
+        double tBFS = nowSeconds() - t0;
+
+        if (bftCount != V || dftCount != V || result.count != V || edgeChecksum(graph) != checksum)
+            valid = 0;
+        double total = tBFT + tDFT + tBFS;
+        if (method == REORDER_NONE) baseline = total;
+        printf("%-22s %10.1f %9.0f %9.1f %9.1f %11.1f %7.2fx\n", reorderNames[method],
+               method == REORDER_NONE ? 0.0 : tBuild * 1e3, averageEdgeSpan(graph),
+               tBFT * 1e3, tDFT * 1e3, tBFS * 1e3, baseline / total);
+        bfsResult_free(&result);
+        if (graph != scrambled) freeGraph(graph);
     }
+    printf("== Result: %s ==\n", valid ? "all orders cover every vertex and preserve every edge" : "MISMATCH");
 
-    free(in_degree_copy);
-    free(q);
+    free(order);
+    free(visit);
+    freeGraph(scrambled);
+}
 
-    if (count != graph->V) {
-        if(printSort) printf("!! Error: Graph contains a cycle. Topological sort not possible.\n");
-        free(sortedOrder);
-        return 0;
+void compressedBenchmark() {
+    printf("\n--- Compressed Adjacency Benchmark (random DAG) ---\n");
+    printf("Number of vertices (e.g. 1000000):\n");
+    int V = getInt();
+    printf("Number of edges (e.g. 10000000):\n");
+    int E = getInt();
+    if (V < 2 || E < 1) {
+        printf("!! Need at least 2 vertices and 1 edge.\n");
+        return;
     }
 
-    if (printSort) {
-        printf("Topological Sort (Kahn's): ");
-        for (int i = 0; i < graph->V; i++)
-            printf("%d ", sortedOrder[i]);
-        printf("\n");
+    Graph* generated = generateRandomDAG(V, E, 2024);
+    int* order = (int*)malloc(V * sizeof(int));
+    int* expected = (int*)malloc(V * sizeof(int));
+    reorder_order(generated, REORDER_NONE, order);
+    Graph* layouts[2];
+    layouts[0] = relabelGraph(generated, order);
+    freeGraph(generated);
+    reorder_order(layouts[0], REORDER_BFS, order);
+    layouts[1] = relabelGraph(layouts[0], order);
+    printf("-> %d vertices, %d edges. Linked AdjListNode payload alone is %zu bytes/edge.\n",
+           V, layouts[0]->E, sizeof(AdjListNode));
+
+    printf("%-14s %-12s %10s %10s %9s %9s %9s\n", "Layout", "Format", "Bytes/edge", "Build (ms)", "BFT (ms)",
+           "DFT (ms)", "Kahn (ms)");
+    int valid = 1;
+    for (int l = 0; l < 2; l++) {
+        Graph* graph = layouts[l];
+        const char* name = l ? "BFS-relabelled" : "As generated";
+        double times[3][2];
+        int (*csrPass[3])(Graph*, int*) = { BFT_order, DFT_order, kahn_order };
+        int (*cgPass[3])(CompressedGraph*, int*) = { cg_BFT_order, cg_DFT_order, cg_kahn_order };
+
+        double t0 = nowSeconds();
+        CompressedGraph* cg = compressGraph(graph);
+        double tBuild = nowSeconds() - t0;
+        for (int k = 0; k < 3; k++) {
+            t0 = nowSeconds();
+            int countCSR = csrPass[k](graph, expected);
+            times[k][0] = nowSeconds() - t0;
+            t0 = nowSeconds();
+            int count = cgPass[k](cg, order);
+            times[k][1] = nowSeconds() - t0;
+            if (count != countCSR || memcmp(order, expected, count * sizeof(int)) != 0)
+                valid = 0;
+        }
+        printf("%-14s %-12s %10.2f %10s %9.1f %9.1f %9.1f\n", name, "CSR",
+               (double)(graph->E + V + 1) * sizeof(int) / graph->E, "-",
+               times[0][0] * 1e3, times[1][0] * 1e3, times[2][0] * 1e3);
+        printf("%-14s %-12s %10.2f %10.1f %9.1f %9.1f %9.1f\n", name, "Delta+varint",
+               (double)cg_memoryBytes(cg) / cg->E, tBuild * 1e3,
+               times[0][1] * 1e3, times[1][1] * 1e3, times[2][1] * 1e3);
+        cg_free(cg);
     }
+    printf("== Result: %s ==\n", valid ? "compressed BFT, DFT and Kahn orders match CSR" : "MISMATCH");
 
-    free(sortedOrder);
-    return 1;
+    free(order);
+    free(expected);
+    freeGraph(layouts[0]);
+    freeGraph(layouts[1]);
+}
+
+void benchmarksMenu() {
+    int choice;
+    while (1) {
+        printf("\n--- Benchmarks ---\n");
+        printf("1. CSR vs Linked Adjacency (large random DAG)\n");
+        printf("2. Deep DFS Stress Test (long chain)\n");
+        printf("3. Parallel BFS (power-law graph, TEPS)\n");
+        printf("4. Parallel Kahn (layered DAG, thread scaling)\n");
+        printf("5. Online Topological Order (Pearce-Kelly)\n");
+        printf("6. Strongly Connected Components (Tarjan)\n");
+        printf("7. Multi-Source BFS vs Repeated BFS\n");
+        printf("8. Reachability Index vs Traversal\n");
+        printf("9. Edge-List Loader (mmap text/binary vs scanf)\n");
+        printf("10. DAG Executor (work-stealing thread scaling)\n");
+        printf("11. Vertex Reordering (BFS/RCM/degree locality)\n");
+        printf("12. Compressed Adjacency (delta + varint vs CSR)\n");
+        printf("13. Back to Main Menu\n");
+        choice = getInt();
+        switch (choice) {
+            case 1: csrBenchmark(); break;
+            case 2: dfsStressTest(); break;
+            case 3: bfsBenchmark(); break;
+            case 4: kahnBenchmark(); break;
+            case 5: onlineTopoBenchmark(); break;
+            case 6: sccBenchmark(); break;
+            case 7: msbfsBenchmark(); break;
+            case 8: reachIndexBenchmark(); break;
+            case 9: loaderBenchmark(); break;
+            case 10: executorBenchmark(); break;
+            case 11: reorderBenchmark(); break;
+            case 12: compressedBenchmark(); break;
+            case 13: return;
+            default: printf("!! Invalid selection. Please try again.\n");
+        }
+    }
 }
 
 Graph* loadDemoGraph(Graph* oldGraph) {
@@ -343,7 +3929,17 @@ int main() {
         printf("3. Traversal (BFT & DFT)\n");
         printf("4. Topological Sort (Demo of 2 methods)\n");
         printf("5. Check if graph is a DAG (Demo of 2 methods)\n");
-        printf("6. Exit\n");
+        printf("6. Online Topological Order (reject cycle-forming edges)\n");
+        printf("7. Strongly Connected Components (cycles + condensation)\n");
+        printf("8. Batch Reachability (multi-source BFS)\n");
+        printf("9. Reachability Queries (interval index)\n");
+        printf("10. Load Graph from Edge-List File\n");
+        printf("11. Save Graph as Edge-List File\n");
+        printf("12. Execute Graph as Task Pipeline (parallel)\n");
+        printf("13. Reorder Vertices for Locality (BFS/RCM/degree)\n");
+        printf("14. Compressed Adjacency Traversals (delta + varint)\n");
+        printf("15. Benchmarks\n");
+        printf("16. Exit\n");
 
         choice = getInt();
 
@@ -384,9 +3980,11 @@ int main() {
                 printf("\n-- Traversal Menu --\n");
                 printf("1. Breadth First Traversal (BFT)\n");
                 printf("2. Depth First Traversal (DFT)\n");
+                printf("3. Parallel BFS with levels (direction-optimizing)\n");
                 int travChoice = getInt();
                 if (travChoice == 1) BFT(graph);
                 else if (travChoice == 2) DFT(graph);
+                else if (travChoice == 3) parallelBFT(graph);
                 else printf("!! Invalid choice.\n");
                 break;
             }
@@ -398,9 +3996,13 @@ int main() {
                 printf("\n-- Topological Sort Menu --\n");
                 printf("1. DFT-Based (Stack method)\n");
                 printf("2. Kahn's Algorithm (In-Degree/Queue method)\n");
+                printf("3. Kahn's Algorithm (parallel frontiers)\n");
+                printf("4. SCC Condensation (works on cyclic graphs)\n");
                 int sortChoice = getInt();
                 if (sortChoice == 1) topologicalSort_DFT(graph);
                 else if (sortChoice == 2) topologicalSort_Kahn(graph, 1);
+                else if (sortChoice == 3) topologicalSort_KahnParallel(graph, 1);
+                else if (sortChoice == 4) topologicalSort_SCC(graph);
                 else printf("!! Invalid choice.\n");
                 break;
             }
@@ -412,6 +4014,7 @@ int main() {
                 printf("\n-- Cycle Check (DAG) Menu --\n");
                 printf("1. DFT-Based (Recursive Stack method)\n");
                 printf("2. Kahn's-Based (In-Degree method)\n");
+                printf("3. Parallel Kahn's-Based (atomic in-degrees)\n");
                 int dagChoice = getInt();
                 if (dagChoice == 1) {
                     if (isDAG_DFT(graph)) printf("Result (DFT): The graph is a DAG.\n");
@@ -419,12 +4022,45 @@ int main() {
                 } else if (dagChoice == 2) {
                     if (topologicalSort_Kahn(graph, 0)) printf("Result (Kahn's): The graph is a DAG.\n");
                     else printf("Result (Kahn's): The graph contains a cycle.\n");
+                } else if (dagChoice == 3) {
+                    if (topologicalSort_KahnParallel(graph, 0)) printf("Result (Parallel Kahn's): The graph is a DAG.\n");
+                    else printf("Result (Parallel Kahn's): The graph contains a cycle.\n");
                 } else {
                     printf("!! Invalid choice.\n");
                 }
                 break;
             }
-            case 6: {
+            case 6:
+                onlineTopoMode(graph);
+                break;
+            case 7:
+                sccAnalysis(graph);
+                break;
+            case 8:
+                batchReachability(graph);
+                break;
+            case 9:
+                reachabilityQueries(graph);
+                break;
+            case 10:
+                graph = loadGraphMenu(graph);
+                break;
+            case 11:
+                saveGraphMenu(graph);
+                break;
+            case 12:
+                executePipeline(graph);
+                break;
+            case 13:
+                graph = reorderGraphMenu(graph);
+                break;
+            case 14:
+                compressedTraversals(graph);
+                break;
+            case 15:
+                benchmarksMenu();
+                break;
+            case 16: {
                 printf("Exiting. Freeing graph memory...\n");
                 freeGraph(graph);
                 return 0;
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h> // For INT_MAX
+#include <string.h> // For strcmp
+#include <time.h>   // For clock_gettime
 
 // --- 1. Graph Data Structures (Adjacency List) ---
 
@@ -72,184 +74,352 @@ void addRoute(Graph* graph, int src, int dest, int time) {
     graph->array[src].head = newNode;
 }
 
-// --- 2. Min-Heap Data Structures (Priority Queue) ---
+// A route stored in a flat route table
+typedef struct Route {
+    int dest;      // Vertex at the other end of the route
+    int time;      // Time (weight) of the route
+} Route;
+
+// Flat (CSR) copy of the graph used by the query engine: the routes leaving
+// v are routes[first[v]] .. routes[first[v + 1] - 1], so a query scans one
+// contiguous array instead of chasing list pointers. The reverse half holds
+// the routes entering each vertex for the backward search.
+typedef struct RouteTable {
+    int V;                // Number of vertices
+    int* first;           // Start of each vertex's outgoing routes (V + 1 entries)
+    Route* routes;        // Outgoing routes, grouped by source vertex
+    int* reverseFirst;    // Start of each vertex's incoming routes (V + 1 entries)
+    Route* reverseRoutes; // Incoming routes, dest holds the source vertex
+} RouteTable;
+
+// Build the route table once after the graph is complete
+RouteTable* buildRouteTable(const Graph* graph) {
+    RouteTable* table = (RouteTable*)malloc(sizeof(RouteTable));
+    if (table == NULL) {
+        perror("malloc failed for RouteTable");
+        exit(EXIT_FAILURE);
+    }
+    int V = graph->V;
+    table->V = V;
+    table->first = (int*)calloc(V + 1, sizeof(int));
+    table->reverseFirst = (int*)calloc(V + 1, sizeof(int));
+    if (table->first == NULL || table->reverseFirst == NULL) {
+        perror("malloc failed for RouteTable offsets");
+        exit(EXIT_FAILURE);
+    }
 
-// A node in the min-heap
-typedef struct MinHeapNode {
-    int v;    // Vertex index
-    int dist; // Distance (time) from source
-} MinHeapNode;
-
-// The min-heap
-typedef struct MinHeap {
-    int size;     // Current number of nodes in heap
-    int capacity; // Maximum capacity
-    int* pos;     // To help with decreaseKey
-    MinHeapNode** array; // Array of heap nodes
-} MinHeap;
-
-// Create a new min-heap node
-MinHeapNode* newMinHeapNode(int v, int dist) {
-    MinHeapNode* node = (MinHeapNode*)malloc(sizeof(MinHeapNode));
-    node->v = v;
-    node->dist = dist;
-    return node;
-}
+    // Count the routes leaving and entering each vertex
+    for (int u = 0; u < V; u++) {
+        for (AdjListNode* pCrawl = graph->array[u].head; pCrawl != NULL; pCrawl = pCrawl->next) {
+            table->first[u + 1]++;
+            table->reverseFirst[pCrawl->dest + 1]++;
+        }
+    }
+    for (int v = 0; v < V; v++) {
+        table->first[v + 1] += table->first[v];
+        table->reverseFirst[v + 1] += table->reverseFirst[v];
+    }
 
-// Create a min-heap
-MinHeap* createMinHeap(int capacity) {
-    MinHeap* minHeap = (MinHeap*)malloc(sizeof(MinHeap));
-    minHeap->pos = (int*)malloc(capacity * sizeof(int));
-    minHeap->size = 0;
-    minHeap->capacity = capacity;
-    minHeap->array = (MinHeapNode**)malloc(capacity * sizeof(MinHeapNode*));
-    return minHeap;
-}
+    int E = table->first[V];
+    table->routes = (Route*)malloc((E > 0 ? E : 1) * sizeof(Route));
+    table->reverseRoutes = (Route*)malloc((E > 0 ? E : 1) * sizeof(Route));
+    int* fill = (int*)malloc((V > 0 ? V : 1) * sizeof(int));
+    if (table->routes == NULL || table->reverseRoutes == NULL || fill == NULL) {
+        perror("malloc failed for RouteTable routes");
+        exit(EXIT_FAILURE);
+    }
 
-// Swap two min-heap nodes
-void swapMinHeapNode(MinHeapNode** a, MinHeapNode** b) {
-    MinHeapNode* t = *a;
-    *a = *b;
-    *b = t;
+    // Copy the routes; each list keeps its original order
+    for (int v = 0; v < V; v++) fill[v] = table->reverseFirst[v];
+    for (int u = 0; u < V; u++) {
+        int e = table->first[u];
+        for (AdjListNode* pCrawl = graph->array[u].head; pCrawl != NULL; pCrawl = pCrawl->next) {
+            table->routes[e].dest = pCrawl->dest;
+            table->routes[e].time = pCrawl->time;
+            e++;
+            Route* in = &table->reverseRoutes[fill[pCrawl->dest]++];
+            in->dest = u;
+            in->time = pCrawl->time;
+        }
+    }
+    free(fill);
+    return table;
 }
 
-// Heapify at a given index
-void minHeapify(MinHeap* minHeap, int idx) {
-    int smallest = idx;
-    int left = 2 * idx + 1;
-    int right = 2 * idx + 2;
+void freeRouteTable(RouteTable* table) {
+    if (table == NULL) return;
+    free(table->first);
+    free(table->routes);
+    free(table->reverseFirst);
+    free(table->reverseRoutes);
+    free(table);
+}
 
-    if (left < minHeap->size && minHeap->array[left]->dist < minHeap->array[smallest]->dist)
-        smallest = left;
-    if (right < minHeap->size && minHeap->array[right]->dist < minHeap->array[smallest]->dist)
-        smallest = right;
+// --- 2. Min-Heap Data Structures (Priority Queue) ---
 
-    if (smallest != idx) {
-        // Swap nodes and their positions
-        MinHeapNode* smallestNode = minHeap->array[smallest];
-        MinHeapNode* idxNode = minHeap->array[idx];
+// One direction of a search: a flat min-heap kept as two parallel (SoA)
+// arrays plus per-vertex state that is reset lazily by stamp
+typedef struct SearchSide {
+    int size;             // Current number of entries in the heap
+    int* heapKey;         // Distance key of each heap slot (one spare slot)
+    int* heapVertex;      // Vertex stored in each heap slot
+    int* pos;             // Heap slot of each vertex, -1 once settled
+    int* dist;            // Shortest time found so far
+    int* pred;            // Previous vertex on the shortest route
+    unsigned* stamp;      // Query that last touched each vertex
+} SearchSide;
+
+// The reusable query workspace: a forward search from the source and a
+// backward search from the target, sharing one query stamp
+typedef struct DijkstraWorkspace {
+    int V;                // Number of vertices the workspace was sized for
+    SearchSide forward;   // Search over outgoing routes from the source
+    SearchSide backward;  // Search over incoming routes from the target
+    unsigned current;     // Stamp of the running query
+} DijkstraWorkspace;
+
+void initSide(SearchSide* side, int V) {
+    side->size = 0;
+    side->heapKey = (int*)malloc((V + 1) * sizeof(int));
+    side->heapVertex = (int*)malloc((V + 1) * sizeof(int));
+    side->pos = (int*)malloc(V * sizeof(int));
+    side->dist = (int*)malloc(V * sizeof(int));
+    side->pred = (int*)malloc(V * sizeof(int));
+    side->stamp = (unsigned*)calloc(V, sizeof(unsigned));
+    if (side->heapKey == NULL || side->heapVertex == NULL || side->pos == NULL ||
+        side->dist == NULL || side->pred == NULL || side->stamp == NULL) {
+        perror("malloc failed for DijkstraWorkspace arrays");
+        exit(EXIT_FAILURE);
+    }
+}
 
-        minHeap->pos[smallestNode->v] = idx;
-        minHeap->pos[idxNode->v] = smallest;
+void freeSide(SearchSide* side) {
+    free(side->heapKey);
+    free(side->heapVertex);
+    free(side->pos);
+    free(side->dist);
+    free(side->pred);
+    free(side->stamp);
+}
 
-        swapMinHeapNode(&minHeap->array[smallest], &minHeap->array[idx]);
-        minHeapify(minHeap, smallest);
+// Allocate a workspace once; every later query reuses it
+DijkstraWorkspace* createWorkspace(int V) {
+    DijkstraWorkspace* ws = (DijkstraWorkspace*)malloc(sizeof(DijkstraWorkspace));
+    if (ws == NULL) {
+        perror("malloc failed for DijkstraWorkspace");
+        exit(EXIT_FAILURE);
     }
+    ws->V = V;
+    initSide(&ws->forward, V);
+    initSide(&ws->backward, V);
+    ws->current = 0;
+    return ws;
 }
 
-// Check if heap is empty
-int isEmpty(MinHeap* minHeap) {
-    return minHeap->size == 0;
+void freeWorkspace(DijkstraWorkspace* ws) {
+    if (ws == NULL) return;
+    freeSide(&ws->forward);
+    freeSide(&ws->backward);
+    free(ws);
 }
 
-// Extract the minimum node from the heap
-MinHeapNode* extractMin(MinHeap* minHeap) {
-    if (isEmpty(minHeap))
-        return NULL;
+// Start a new query in O(1): bumping the stamp invalidates every vertex
+void beginQuery(DijkstraWorkspace* ws) {
+    ws->forward.size = 0;
+    ws->backward.size = 0;
+    if (++ws->current == 0) {
+        // Stamp wrapped around, so old stamps could look current again
+        for (int v = 0; v < ws->V; v++) {
+            ws->forward.stamp[v] = 0;
+            ws->backward.stamp[v] = 0;
+        }
+        ws->current = 1;
+    }
+}
 
-    // Get the root
-    MinHeapNode* root = minHeap->array[0];
+// Move the entry at slot i up while its parent has a larger key
+void siftUp(SearchSide* side, int i) {
+    int key = side->heapKey[i];
+    int v = side->heapVertex[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (side->heapKey[parent] <= key) break;
+        side->heapKey[i] = side->heapKey[parent];
+        side->heapVertex[i] = side->heapVertex[parent];
+        side->pos[side->heapVertex[i]] = i;
+        i = parent;
+    }
+    side->heapKey[i] = key;
+    side->heapVertex[i] = v;
+    side->pos[v] = i;
+}
 
-    // Replace root with the last node
-    MinHeapNode* lastNode = minHeap->array[minHeap->size - 1];
-    minHeap->array[0] = lastNode;
+// Move the entry at slot i down while a child has a smaller key. The spare
+// slot past the end holds INT_MAX, so the smaller child is picked without
+// a bounds check or a hard-to-predict branch.
+void siftDown(SearchSide* side, int i) {
+    int key = side->heapKey[i];
+    int v = side->heapVertex[i];
+    side->heapKey[side->size] = INT_MAX;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= side->size) break;
+        child += side->heapKey[child + 1] < side->heapKey[child];
+        if (side->heapKey[child] >= key) break;
+        side->heapKey[i] = side->heapKey[child];
+        side->heapVertex[i] = side->heapVertex[child];
+        side->pos[side->heapVertex[i]] = i;
+        i = child;
+    }
+    side->heapKey[i] = key;
+    side->heapVertex[i] = v;
+    side->pos[v] = i;
+}
 
-    // Update position
-    minHeap->pos[root->v] = minHeap->size - 1;
-    minHeap->pos[lastNode->v] = 0;
+// Insert vertex v with distance dist
+void heapPush(SearchSide* side, int v, int dist) {
+    int i = side->size++;
+    side->heapKey[i] = dist;
+    side->heapVertex[i] = v;
+    siftUp(side, i);
+}
 
-    // Reduce size and heapify
-    --minHeap->size;
-    minHeapify(minHeap, 0);
+// Lower the key of a vertex that is still in the heap
+void decreaseKey(SearchSide* side, int v, int dist) {
+    int i = side->pos[v];
+    side->heapKey[i] = dist;
+    siftUp(side, i);
+}
 
+// Remove and return the vertex with the smallest distance (marks it settled)
+int extractMin(SearchSide* side) {
+    int root = side->heapVertex[0];
+    side->pos[root] = -1;
+    if (--side->size > 0) {
+        side->heapKey[0] = side->heapKey[side->size];
+        side->heapVertex[0] = side->heapVertex[side->size];
+        siftDown(side, 0);
+    }
     return root;
 }
 
-// Decrease distance value of a vertex v
-void decreaseKey(MinHeap* minHeap, int v, int dist) {
-    // Get the index of v in the heap array
-    int i = minHeap->pos[v];
-    
-    // Update the distance
-    minHeap->array[i]->dist = dist;
-
-    // "Bubble up" while parent is greater
-    while (i > 0 && minHeap->array[i]->dist < minHeap->array[(i - 1) / 2]->dist) {
-        // Swap with parent
-        minHeap->pos[minHeap->array[i]->v] = (i - 1) / 2;
-        minHeap->pos[minHeap->array[(i - 1) / 2]->v] = i;
-        swapMinHeapNode(&minHeap->array[i], &minHeap->array[(i - 1) / 2]);
-        
-        // move to parent's index
-        i = (i - 1) / 2;
-    }
+// --- 3. Dijkstra's Algorithm Implementation ---
+
+// Shortest time to v from the last query's source (INT_MAX if not reached)
+int getDist(const DijkstraWorkspace* ws, int v) {
+    return ws->forward.stamp[v] == ws->current ? ws->forward.dist[v] : INT_MAX;
 }
 
-// Check if a vertex is in the min-heap
-int isInMinHeap(MinHeap* minHeap, int v) {
-    if (minHeap->pos[v] < minHeap->size)
-        return 1;
-    return 0;
+// Previous vertex on the shortest route to v (-1 for the source or if not reached)
+int getPred(const DijkstraWorkspace* ws, int v) {
+    return ws->forward.stamp[v] == ws->current ? ws->forward.pred[v] : -1;
 }
 
-// --- 3. Dijkstra's Algorithm Implementation ---
+// Put the source (or target) of a query into one side's heap
+void startSide(SearchSide* side, unsigned current, int v) {
+    side->stamp[v] = current;
+    side->dist[v] = 0;
+    side->pred[v] = -1;
+    heapPush(side, v, 0);
+}
 
-void dijkstra(Graph* graph, int src) {
-    int V = graph->V;
-    int* dist = (int*)malloc(V * sizeof(int)); // Holds shortest times
-    
+// Settle the closest vertex of `side` and relax its routes. If `other` is
+// given, every improved label is checked against the other search and the
+// best meeting point seen so far is kept in *best / *meet.
+void settleNext(SearchSide* side, const int* first, const Route* routes, unsigned current,
+                const SearchSide* other, int* best, int* meet) {
+    int u = extractMin(side);
+    int du = side->dist[u];
+    for (int e = first[u]; e < first[u + 1]; e++) {
+        int v = routes[e].dest;
+        int dv = du + routes[e].time;
+        if (side->stamp[v] != current) {
+            // First time this search reaches v
+            side->stamp[v] = current;
+            side->dist[v] = dv;
+            side->pred[v] = u;
+            heapPush(side, v, dv);
+        } else if (side->pos[v] >= 0 && dv < side->dist[v]) {
+            // A shorter path to a vertex still in the queue
+            side->dist[v] = dv;
+            side->pred[v] = u;
+            decreaseKey(side, v, dv);
+        } else {
+            continue;
+        }
+        if (other != NULL && other->stamp[v] == current && dv + other->dist[v] < *best) {
+            *best = dv + other->dist[v];
+            *meet = v;
+        }
+    }
+}
+
+// Run one query from src without allocating. If target >= 0 a forward search
+// from src and a backward search from target run until they meet, and the
+// target's time is returned (INT_MAX if unreachable); the route is spliced
+// into the forward side, so getPred walks it back from target to src and
+// getDist is exact along it. With target == -1 every reachable vertex is
+// settled and 0 is returned. Results are read back until the next query.
+int dijkstraQuery(DijkstraWorkspace* ws, const RouteTable* table, int src, int target) {
     // --- Validation 2: Check for valid graph and source ---
-    if (graph == NULL || src < 0 || src >= V) {
+    if (table == NULL || ws == NULL || ws->V < table->V || src < 0 || src >= table->V || target >= table->V) {
         printf("Validation Error: Invalid graph or source vertex.\n");
-        if (dist) free(dist);
-        return;
+        return INT_MAX;
     }
 
-    // Create and initialize the min-heap
-    MinHeap* minHeap = createMinHeap(V);
-    
-    // Initialize distances and heap
-    for (int v = 0; v < V; ++v) {
-        dist[v] = INT_MAX;
-        minHeap->array[v] = newMinHeapNode(v, dist[v]);
-        minHeap->pos[v] = v;
+    SearchSide* fwd = &ws->forward;
+    SearchSide* bwd = &ws->backward;
+    beginQuery(ws);
+    startSide(fwd, ws->current, src);
+
+    if (target < 0) {
+        while (fwd->size > 0)
+            settleNext(fwd, table->first, table->routes, ws->current, NULL, NULL, NULL);
+        return 0;
     }
 
-    // Set source distance to 0 and update heap
-    dist[src] = 0;
-    decreaseKey(minHeap, src, 0);
-
-    minHeap->size = V;
-
-    // Main loop
-    while (!isEmpty(minHeap)) {
-        // Greedily extract the unvisited node with the smallest time
-        MinHeapNode* minHeapNode = extractMin(minHeap);
-        int u = minHeapNode->v; // Vertex index
-
-        // Iterate over all neighbors
-        AdjListNode* pCrawl = graph->array[u].head;
-        while (pCrawl != NULL) {
-            int v = pCrawl->dest;
-
-            // If a shorter path is found
-            if (isInMinHeap(minHeap, v) && dist[u] != INT_MAX &&
-                pCrawl->time + dist[u] < dist[v]) 
-            {
-                dist[v] = dist[u] + pCrawl->time;
-                // Update the distance in the priority queue
-                decreaseKey(minHeap, v, dist[v]);
-            }
-            pCrawl = pCrawl->next;
-        }
-        free(minHeapNode); // Free the extracted node
+    startSide(bwd, ws->current, target);
+    int best = src == target ? 0 : INT_MAX;
+    int meet = src;
+    // Stop once no route through the unsettled vertices can beat the best one
+    while (fwd->size > 0 && bwd->size > 0 &&
+           (long)fwd->heapKey[0] + bwd->heapKey[0] < best) {
+        // Grow whichever search is closer to home
+        if (fwd->heapKey[0] <= bwd->heapKey[0])
+            settleNext(fwd, table->first, table->routes, ws->current, bwd, &best, &meet);
+        else
+            settleNext(bwd, table->reverseFirst, table->reverseRoutes, ws->current, fwd, &best, &meet);
+    }
+    if (best == INT_MAX) return INT_MAX;
+
+    // Copy the backward half of the route (meet -> target) into the forward side
+    for (int v = meet; v != target; ) {
+        int next = bwd->pred[v];
+        fwd->stamp[next] = ws->current;
+        fwd->pred[next] = v;
+        fwd->dist[next] = best - bwd->dist[next];
+        v = next;
     }
+    return best;
+}
 
-    // Print the results
+// Full single-source run that fills the caller's dist and pred arrays
+// (INT_MAX / -1 for unreachable vertices). Returns 0 if validation failed.
+int dijkstra(DijkstraWorkspace* ws, const RouteTable* table, int src, int* dist, int* pred) {
+    if (dijkstraQuery(ws, table, src, -1) != 0) return 0;
+    for (int v = 0; v < table->V; v++) {
+        dist[v] = getDist(ws, v);
+        pred[v] = getPred(ws, v);
+    }
+    return 1;
+}
+
+// Print the delivery times returned by dijkstra()
+void printDeliveryTimes(const int* dist, int V) {
     printf(" Shortest Delivery Times from: Warehouse (Node 0)\n");
     printf("--------------------------------------------------\n");
-    char* locations[] = {"Warehouse", "Pharmacy A", "Hospital B", "Clinic C", "Patient Home D"};
-    
+    const char* locations[] = {"Warehouse", "Pharmacy A", "Hospital B", "Clinic C", "Patient Home D"};
+
     for (int i = 0; i < V; ++i) {
         if (dist[i] == INT_MAX) {
             printf("Location: %-18s (Node %d) | Time: UNREACHABLE\n", locations[i], i);
@@ -257,13 +427,6 @@ void dijkstra(Graph* graph, int src) {
             printf("Location: %-18s (Node %d) | Time: %d minutes\n", locations[i], i, dist[i]);
         }
     }
-
-    // --- 4. Free all allocated memory ---
-    free(dist);
-    // Free heap (nodes were freed in extractMin)
-    free(minHeap->pos);
-    free(minHeap->array);
-    free(minHeap);
 }
 
 // Helper function to free the entire graph
@@ -282,9 +445,155 @@ void freeGraph(Graph* graph) {
 }
 
 
+// --- 4. City Road Network Benchmark ---
+
+double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+unsigned nextRandom(unsigned* state) {
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// A rows x cols street grid: every intersection has two-way streets to its
+// neighbours with 1-9 minute travel times, and every 10th street is a faster avenue
+Graph* createCityGrid(int rows, int cols, unsigned seed) {
+    Graph* graph = createGraph(rows * cols);
+    unsigned state = seed ? seed : 1;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int v = r * cols + c;
+            if (c + 1 < cols) {
+                int time = (r % 10 == 0) ? 1 : 1 + nextRandom(&state) % 9;
+                addRoute(graph, v, v + 1, time);
+                addRoute(graph, v + 1, v, time);
+            }
+            if (r + 1 < rows) {
+                int time = (c % 10 == 0) ? 1 : 1 + nextRandom(&state) % 9;
+                addRoute(graph, v, v + cols, time);
+                addRoute(graph, v + cols, v, time);
+            }
+        }
+    }
+    return graph;
+}
+
+// Pick a random destination within `radius` blocks of src (any vertex if radius < 0)
+int pickDestination(int src, int rows, int cols, int radius, unsigned* state) {
+    if (radius < 0) return nextRandom(state) % (rows * cols);
+    int r = src / cols + (int)(nextRandom(state) % (2 * radius + 1)) - radius;
+    int c = src % cols + (int)(nextRandom(state) % (2 * radius + 1)) - radius;
+    if (r < 0) r = 0;
+    if (r >= rows) r = rows - 1;
+    if (c < 0) c = 0;
+    if (c >= cols) c = cols - 1;
+    return r * cols + c;
+}
+
+// Check a route by walking predecessors back from target and summing route times
+int routeTime(Graph* graph, const DijkstraWorkspace* ws, int src, int target) {
+    int total = 0;
+    for (int v = target; v != src; v = getPred(ws, v)) {
+        int u = getPred(ws, v);
+        if (u < 0) return -1;
+        int best = INT_MAX;
+        for (AdjListNode* pCrawl = graph->array[u].head; pCrawl != NULL; pCrawl = pCrawl->next)
+            if (pCrawl->dest == v && pCrawl->time < best) best = pCrawl->time;
+        total += best;
+    }
+    return total;
+}
+
+void benchmarkQueries(int rows, int cols, int queries) {
+    Graph* graph = createCityGrid(rows, cols, 2024);
+    RouteTable* table = buildRouteTable(graph);
+    int V = graph->V;
+    DijkstraWorkspace* ws = createWorkspace(V);
+    int* dist = (int*)malloc(V * sizeof(int));
+    int* pred = (int*)malloc(V * sizeof(int));
+    if (dist == NULL || pred == NULL) {
+        perror("malloc failed for benchmark arrays");
+        exit(EXIT_FAILURE);
+    }
+    printf(" City Road Network: %d x %d grid (%d intersections)\n", rows, cols, V);
+    printf("--------------------------------------------------\n");
+
+    // --- Validation: point-to-point answers and routes agree with full runs ---
+    unsigned state = 7;
+    int errors = 0;
+    for (int i = 0; i < 200; i++) {
+        int src = nextRandom(&state) % V;
+        int target = pickDestination(src, rows, cols, i % 2 ? 8 : -1, &state);
+        int time = dijkstraQuery(ws, table, src, target);
+        if (routeTime(graph, ws, src, target) != time) errors++;
+        dijkstra(ws, table, src, dist, pred);
+        if (dist[target] != time) errors++;
+    }
+
+    printf("%-36s %9s %10s %12s\n", "Query mode", "Queries", "Time (s)", "Queries/sec");
+    long checksum = 0;
+    for (int mode = 0; mode < 4; mode++) {
+        // 0: deliveries within 8 blocks, allocating and clearing a workspace per
+        // query like the old dijkstra(); 1: the same with the reused workspace;
+        // 2: random pairs across the city; 3: full single-source runs
+        int n = mode == 1 ? queries : mode == 0 ? (queries / 10 > 0 ? queries / 10 : 1)
+                                                : (queries / 100 > 0 ? queries / 100 : 1);
+        const char* names[] = { "Fresh workspace, within 8 blocks", "Reused workspace, within 8 blocks",
+                                "Reused workspace, random pairs", "Reused workspace, full single-source" };
+        state = 99;
+        double t0 = nowSeconds();
+        for (int i = 0; i < n; i++) {
+            int src = nextRandom(&state) % V;
+            if (mode == 3) {
+                dijkstra(ws, table, src, dist, pred);
+                checksum += dist[V - 1 - src];
+                continue;
+            }
+            int target = pickDestination(src, rows, cols, mode <= 1 ? 8 : -1, &state);
+            if (mode == 0) {
+                DijkstraWorkspace* fresh = createWorkspace(V);
+                checksum += dijkstraQuery(fresh, table, src, target);
+                freeWorkspace(fresh);
+            } else {
+                checksum += dijkstraQuery(ws, table, src, target);
+            }
+        }
+        double elapsed = nowSeconds() - t0;
+        printf("%-36s %9d %10.3f %12.0f\n", names[mode], n, elapsed, n / elapsed);
+    }
+    printf("--------------------------------------------------\n");
+    printf("Route check: %s (checksum %ld)\n", errors == 0 ? "all routes match" : "MISMATCH", checksum);
+
+    free(dist);
+    free(pred);
+    freeWorkspace(ws);
+    freeRouteTable(table);
+    freeGraph(graph);
+}
+
 // --- 5. Main (Driver) Function ---
 
-int main() {
+int main(int argc, char* argv[]) {
+    // "bench [rows] [cols] [queries]" runs the city road network benchmark instead
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        int rows = argc > 2 ? atoi(argv[2]) : 100;
+        int cols = argc > 3 ? atoi(argv[3]) : 100;
+        int queries = argc > 4 ? atoi(argv[4]) : 100000;
+        if (rows <= 0 || cols <= 0 || queries <= 0) {
+            printf("Validation Error: Grid size and query count must be positive.\n");
+            return 1;
+        }
+        benchmarkQueries(rows, cols, queries);
+        return 0;
+    }
+
     int V = 5; // 5 locations
     Graph* graph = createGraph(V);
 
@@ -307,9 +616,15 @@ int main() {
     addRoute(graph, 4, 3, 5);  // D -> C (5)
 
     // Run Dijkstra's from the Warehouse (Node 0)
-    dijkstra(graph, 0);
+    RouteTable* table = buildRouteTable(graph);
+    DijkstraWorkspace* ws = createWorkspace(V);
+    int dist[5], pred[5];
+    if (dijkstra(ws, table, 0, dist, pred))
+        printDeliveryTimes(dist, V);
     
     // Clean up memory
+    freeWorkspace(ws);
+    freeRouteTable(table);
     freeGraph(graph);
 
     return 0;